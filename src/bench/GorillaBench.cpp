@@ -0,0 +1,167 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include "cpu/CpuMonitor.hpp"
+#include "memory/MemoryMonitor.hpp"
+#include "pressure/PressureMonitor.hpp"
+#include "history/MetricStore.hpp"
+#include "history/GorillaChunk.hpp"
+
+/**
+ * Benchmark of the Gorilla chunk encoding on recorded /proc traces.
+ *
+ * Records every metric of the collectors (cpu, cpu.<mode>, memory, swap, psi.<resource>)
+ * on a fixed period, exactly as the scheduler does, then reports the compressed size per
+ * sample and the encode/decode throughput, once at full precision and once rounded to the
+ * default `history_precision` of 2 decimals.
+ *
+ * Usage: GorillaBench [seconds] [intervalMS]
+ */
+
+static const size_t SAMPLES_PER_CHUNK = 1024;
+static volatile double sink;
+
+static std::vector<std::vector<Sample>> recordTraces(int seconds, int intervalMS)
+{
+    CpuMonitor cpu;
+    MemoryMonitor memory;
+    PressureMonitor pressure;
+    MetricStore store(static_cast<size_t>(seconds) * 1000 / intervalMS + 1, 1024 * 1024 * 1024, 1);
+    cpu.setMetricStore(store);
+    memory.setMetricStore(store);
+    pressure.setMetricStore(store);
+
+    std::cout << "recording " << store.getNames().size() << " metrics for " << seconds << " s every " << intervalMS << " ms" << std::endl;
+
+    auto next = std::chrono::steady_clock::now();
+    auto end = next + std::chrono::seconds(seconds);
+    while (next < end)
+    {
+        cpu.sample();
+        memory.sample();
+        pressure.sample();
+        next += std::chrono::milliseconds(intervalMS);
+        std::this_thread::sleep_until(next);
+    }
+
+    std::vector<std::vector<Sample>> traces(store.getNames().size());
+    for (size_t id = 0; id < traces.size(); id++)
+    {
+        store.getRing(static_cast<int>(id))->readLast(store.getRing(static_cast<int>(id))->getCapacity(), traces[id]);
+    }
+    return traces;
+}
+
+static std::vector<GorillaChunk> encode(const std::vector<std::vector<Sample>> &traces)
+{
+    std::vector<GorillaChunk> chunks;
+    for (const auto &trace : traces)
+    {
+        for (size_t i = 0; i < trace.size(); i++)
+        {
+            if (i % SAMPLES_PER_CHUNK == 0)
+            {
+                chunks.emplace_back();
+            }
+            chunks.back().append(trace[i].timeMS, trace[i].value);
+        }
+    }
+    return chunks;
+}
+
+static size_t decode(const std::vector<GorillaChunk> &chunks)
+{
+    size_t samples = 0;
+    for (const auto &chunk : chunks)
+    {
+        GorillaChunk::Iterator iterator = chunk.iterate();
+        Sample sample;
+        while (iterator.next(sample))
+        {
+            sink = sample.value;
+            samples++;
+        }
+    }
+    return samples;
+}
+
+// Runs `function` until at least 200 ms passed, returns nanoseconds per sample
+template <typename Function>
+static double measure(size_t samplesPerRun, Function function)
+{
+    int runs = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration elapsed;
+    do
+    {
+        function();
+        runs++;
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed < std::chrono::milliseconds(200));
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (static_cast<double>(runs) * samplesPerRun);
+}
+
+static void report(const std::string &name, const std::vector<std::vector<Sample>> &traces)
+{
+    size_t samples = 0;
+    for (const auto &trace : traces)
+    {
+        samples += trace.size();
+    }
+
+    std::vector<GorillaChunk> chunks = encode(traces);
+    size_t bytes = 0;
+    for (const auto &chunk : chunks)
+    {
+        bytes += chunk.getSizeBytes();
+    }
+
+    if (decode(chunks) != samples)
+    {
+        std::cerr << "decoded sample count mismatch" << std::endl;
+        std::exit(1);
+    }
+
+    double encodeNS = measure(samples, [&traces]()
+                              { sink = static_cast<double>(encode(traces).size()); });
+    double decodeNS = measure(samples, [&chunks]()
+                              { decode(chunks); });
+
+    double bytesPerSample = static_cast<double>(bytes) / samples;
+    std::cout << name << "\n"
+              << "  samples     : " << samples << "\n"
+              << "  size        : " << bytesPerSample << " bytes/sample (raw 16, ratio " << 16.0 / bytesPerSample << "x)\n"
+              << "  encode      : " << encodeNS << " ns/sample (" << 1000.0 / encodeNS << " M samples/s)\n"
+              << "  decode      : " << decodeNS << " ns/sample (" << 1000.0 / decodeNS << " M samples/s)\n";
+}
+
+int main(int argc, char **argv)
+{
+    int seconds = argc > 1 ? std::atoi(argv[1]) : 60;
+    int intervalMS = argc > 2 ? std::atoi(argv[2]) : 500;
+    if (seconds < 1 || intervalMS < 1)
+    {
+        std::cerr << "Usage: GorillaBench [seconds] [intervalMS]" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::vector<Sample>> traces = recordTraces(seconds, intervalMS);
+
+    std::vector<std::vector<Sample>> rounded = traces;
+    for (auto &trace : rounded)
+    {
+        for (Sample &sample : trace)
+        {
+            sample.value = std::round(sample.value * 100.0) / 100.0;
+        }
+    }
+
+    report("full precision", traces);
+    report("history_precision 2", rounded);
+
+    return 0;
+}
@@ -0,0 +1,302 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <csignal>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/ec.h>
+#include <openssl/pem.h>
+#include <openssl/x509v3.h>
+#include "telegram/PooledHttpClient.hpp"
+
+/**
+ * Benchmark of Bot API connection reuse against a local HTTPS stand-in server.
+ *
+ * The server speaks just enough HTTP/1.1 over TLS to answer every request with a Bot API
+ * style `{"ok":true,...}` body on a keep-alive connection. It uses a self-signed
+ * certificate for 127.0.0.1 that is written to a temporary CA file for the client.
+ * To model a real network path, it waits one `rtt` before the TLS handshake (TCP connect),
+ * one more when the handshake was not a resumption (TLS 1.2 style full handshake) and one
+ * before each response.
+ *
+ * The same sendMessage load is run by `threads` threads through `PooledHttpClient` in each
+ * of its modes: FRESH (new connection and full handshake per call, like the default tgbot
+ * client), RESUME_ONLY (new connection, resumed TLS session) and KEEP_ALIVE.
+ *
+ * Usage: HttpClientBench [requests] [threads] [rttMS]
+ */
+
+struct ServerStats
+{
+    std::atomic<uint64_t> handshakes{0};
+    std::atomic<uint64_t> resumed{0};
+    std::atomic<uint64_t> requests{0};
+};
+
+static void sleepMS(int ms)
+{
+    if (ms > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+}
+
+// Self-signed P-256 certificate for 127.0.0.1, written as PEM to `caFile`
+static void createCertificate(SSL_CTX *context, const std::string &caFile)
+{
+    EVP_PKEY *key = nullptr;
+    EVP_PKEY_CTX *keyContext = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    if (!keyContext || EVP_PKEY_keygen_init(keyContext) <= 0 ||
+        EVP_PKEY_CTX_set_ec_paramgen_curve_nid(keyContext, NID_X9_62_prime256v1) <= 0 ||
+        EVP_PKEY_keygen(keyContext, &key) <= 0)
+    {
+        throw std::runtime_error("key generation failed");
+    }
+    EVP_PKEY_CTX_free(keyContext);
+
+    X509 *certificate = X509_new();
+    X509_set_version(certificate, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+    X509_gmtime_adj(X509_getm_notBefore(certificate), -3600);
+    X509_gmtime_adj(X509_getm_notAfter(certificate), 86400);
+    X509_set_pubkey(certificate, key);
+    X509_NAME *name = X509_get_subject_name(certificate);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char *>("127.0.0.1"), -1, -1, 0);
+    X509_set_issuer_name(certificate, name);
+
+    X509V3_CTX extensionContext;
+    X509V3_set_ctx(&extensionContext, certificate, certificate, nullptr, nullptr, 0);
+    const char *extensions[][2] = {{"subjectAltName", "IP:127.0.0.1"}, {"basicConstraints", "critical,CA:TRUE"}};
+    for (const auto &extension : extensions)
+    {
+        X509_EXTENSION *entry = X509V3_EXT_conf(nullptr, &extensionContext, extension[0], extension[1]);
+        X509_add_ext(certificate, entry, -1);
+        X509_EXTENSION_free(entry);
+    }
+    X509_sign(certificate, key, EVP_sha256());
+
+    FILE *file = fopen(caFile.c_str(), "w");
+    if (!file)
+    {
+        throw std::runtime_error("cannot write " + caFile);
+    }
+    PEM_write_X509(file, certificate);
+    fclose(file);
+
+    SSL_CTX_use_certificate(context, certificate);
+    SSL_CTX_use_PrivateKey(context, key);
+    X509_free(certificate);
+    EVP_PKEY_free(key);
+}
+
+// Reads one request (headers and Content-Length body), false when the client closed
+static bool readRequest(SSL *ssl, std::string &buffer)
+{
+    char chunk[16384];
+    size_t headerEnd;
+    while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos)
+    {
+        int count = SSL_read(ssl, chunk, sizeof(chunk));
+        if (count <= 0)
+        {
+            return false;
+        }
+        buffer.append(chunk, count);
+    }
+
+    size_t length = 0;
+    size_t field = buffer.find("Content-Length:");
+    if (field == std::string::npos)
+    {
+        field = buffer.find("content-length:");
+    }
+    if (field != std::string::npos && field < headerEnd)
+    {
+        length = std::strtoul(buffer.c_str() + field + 15, nullptr, 10);
+    }
+
+    size_t total = headerEnd + 4 + length;
+    while (buffer.size() < total)
+    {
+        int count = SSL_read(ssl, chunk, sizeof(chunk));
+        if (count <= 0)
+        {
+            return false;
+        }
+        buffer.append(chunk, count);
+    }
+    buffer.erase(0, total);
+    return true;
+}
+
+static void serveConnection(SSL_CTX *context, int fd, int rttMS, ServerStats &stats)
+{
+    int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    sleepMS(rttMS);
+
+    SSL *ssl = SSL_new(context);
+    SSL_set_fd(ssl, fd);
+    if (SSL_accept(ssl) == 1)
+    {
+        stats.handshakes++;
+        if (SSL_session_reused(ssl))
+        {
+            stats.resumed++;
+        }
+        else
+        {
+            sleepMS(rttMS);
+        }
+
+        const std::string body = "{\"ok\":true,\"result\":{\"message_id\":1,\"date\":0,\"chat\":{\"id\":1,\"type\":\"private\"},\"text\":\"ok\"}}";
+        const std::string response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: keep-alive\r\n"
+                                     "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+        std::string buffer;
+        while (readRequest(ssl, buffer))
+        {
+            stats.requests++;
+            sleepMS(rttMS);
+            if (SSL_write(ssl, response.data(), static_cast<int>(response.size())) <= 0)
+            {
+                break;
+            }
+        }
+        SSL_shutdown(ssl);
+    }
+    SSL_free(ssl);
+    close(fd);
+}
+
+static double percentile(std::vector<double> &values, double q)
+{
+    size_t index = static_cast<size_t>(q * (values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+int main(int argc, char **argv)
+{
+    int requests = argc > 1 ? std::atoi(argv[1]) : 200;
+    int threads = argc > 2 ? std::atoi(argv[2]) : 4;
+    int rttMS = argc > 3 ? std::atoi(argv[3]) : 20;
+    signal(SIGPIPE, SIG_IGN);
+
+    char caFile[] = "/tmp/HttpClientBenchCA.XXXXXX";
+    int caFd = mkstemp(caFile);
+    if (caFd < 0)
+    {
+        std::cerr << "mkstemp failed" << std::endl;
+        return 1;
+    }
+    close(caFd);
+
+    SSL_CTX *context = SSL_CTX_new(TLS_server_method());
+    createCertificate(context, caFile);
+    SSL_CTX_set_session_id_context(context, reinterpret_cast<const unsigned char *>("bench"), 5);
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressLength = sizeof(address);
+    if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(listener, 128) != 0 ||
+        getsockname(listener, reinterpret_cast<sockaddr *>(&address), &addressLength) != 0)
+    {
+        std::cerr << "cannot listen on 127.0.0.1" << std::endl;
+        return 1;
+    }
+
+    ServerStats stats;
+    std::thread([&]
+                {
+                    for (;;)
+                    {
+                        int fd = accept(listener, nullptr, nullptr);
+                        if (fd >= 0)
+                        {
+                            std::thread(serveConnection, context, fd, rttMS, std::ref(stats)).detach();
+                        }
+                    } })
+        .detach();
+
+    const TgBot::Url url("https://127.0.0.1:" + std::to_string(ntohs(address.sin_port)) + "/bot123:TOKEN/sendMessage");
+    const std::vector<TgBot::HttpReqArg> args = {TgBot::HttpReqArg("chat_id", 1), TgBot::HttpReqArg("text", "CPU usage 97%")};
+
+    std::cout << requests << " sendMessage calls on " << threads << " threads, rtt " << rttMS << " ms" << std::endl;
+
+    const std::pair<PooledHttpClient::ConnectionMode, const char *> modes[] = {
+        {PooledHttpClient::FRESH, "fresh"}, {PooledHttpClient::RESUME_ONLY, "resume only"}, {PooledHttpClient::KEEP_ALIVE, "keep-alive"}};
+    for (const auto &mode : modes)
+    {
+        PooledHttpClient client(mode.first, threads, caFile);
+        uint64_t handshakes = stats.handshakes, resumed = stats.resumed;
+        std::vector<std::vector<double>> latencies(threads);
+        std::atomic<int> failures(0);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++)
+        {
+            workers.emplace_back([&, t]
+                                 {
+                                     for (int i = t; i < requests; i += threads)
+                                     {
+                                         auto begin = std::chrono::steady_clock::now();
+                                         try
+                                         {
+                                             client.makeRequest(url, args);
+                                         }
+                                         catch (const std::exception &e)
+                                         {
+                                             if (failures++ == 0)
+                                             {
+                                                 std::cerr << e.what() << std::endl;
+                                             }
+                                             continue;
+                                         }
+                                         latencies[t].push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+                                     } });
+        }
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<double> all;
+        for (const std::vector<double> &latency : latencies)
+        {
+            all.insert(all.end(), latency.begin(), latency.end());
+        }
+        if (all.empty())
+        {
+            std::cout << mode.second << " : all requests failed" << std::endl;
+            continue;
+        }
+
+        char line[256];
+        snprintf(line, sizeof(line), "%-12s %8.1f req/s  p50 %7.2f ms  p99 %7.2f ms  connections %4llu  handshakes %4llu (%llu resumed)  failed %d",
+                 mode.second, all.size() / seconds, percentile(all, 0.5), percentile(all, 0.99),
+                 static_cast<unsigned long long>(client.getConnectionCount()),
+                 static_cast<unsigned long long>(stats.handshakes - handshakes),
+                 static_cast<unsigned long long>(stats.resumed - resumed), failures.load());
+        std::cout << line << std::endl;
+    }
+
+    unlink(caFile);
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include "proc/ProcFile.hpp"
+#include "proc/ProcScanner.hpp"
+
+/**
+ * Microbenchmark of the /proc read path.
+ *
+ * Compares the former iostream path of `CpuMonitor::readCpuTimes` and
+ * `MemoryMonitor::sample` (ifstream + getline + istringstream per sample) with the
+ * persistent-descriptor `ProcFile` + `ProcScanner` path that replaced it.
+ *
+ * Usage: ProcReaderBench [iterations]
+ */
+
+static volatile uint64_t sink;
+
+static void legacyStat()
+{
+    std::ifstream statFile("/proc/stat");
+    std::string line;
+    std::getline(statFile, line);
+    std::istringstream iss(line);
+    std::string cpuLabel;
+    long long user, nice, system, idle;
+    iss >> cpuLabel >> user >> nice >> system >> idle;
+    sink += user + idle;
+}
+
+static void procFileStat(ProcFile &statFile)
+{
+    statFile.read();
+    ProcScanner scanner(statFile.data(), statFile.size());
+    uint64_t user = 0, nice = 0, system = 0, idle = 0;
+    scanner.match("cpu ");
+    scanner.readUInt(user);
+    scanner.readUInt(nice);
+    scanner.readUInt(system);
+    scanner.readUInt(idle);
+    sink += user + idle;
+}
+
+static void legacyMemInfo()
+{
+    std::ifstream memInfoFile("/proc/meminfo");
+    std::string line;
+    long long total = 0, available = 0;
+    while (std::getline(memInfoFile, line))
+    {
+        std::istringstream iss(line);
+        std::string key, unit;
+        long long value;
+        iss >> key >> value >> unit;
+        if (key == "MemTotal:")
+            total = value;
+        if (key == "MemAvailable:")
+            available = value;
+    }
+    sink += total + available;
+}
+
+static void procFileMemInfo(ProcFile &memInfoFile)
+{
+    memInfoFile.read();
+    ProcScanner scanner(memInfoFile.data(), memInfoFile.size());
+    uint64_t total = 0, available = 0;
+    while (!scanner.atEnd())
+    {
+        if (scanner.match("MemTotal:"))
+            scanner.readUInt(total);
+        else if (scanner.match("MemAvailable:"))
+            scanner.readUInt(available);
+        scanner.nextLine();
+    }
+    sink += total + available;
+}
+
+template <typename Function>
+static double measure(int iterations, Function function)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        function();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+static void report(const std::string &name, double legacyNS, double procFileNS)
+{
+    std::cout << name << "\n"
+              << "  iostream : " << static_cast<long long>(legacyNS) << " ns/sample\n"
+              << "  ProcFile : " << static_cast<long long>(procFileNS) << " ns/sample\n"
+              << "  speedup  : " << legacyNS / procFileNS << "x\n";
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+    ProcFile statFile("/proc/stat");
+    ProcFile memInfoFile("/proc/meminfo");
+    if (!statFile.isOpen() || !memInfoFile.isOpen())
+    {
+        std::cerr << "Error opening /proc files" << std::endl;
+        return 1;
+    }
+
+    double legacyStatNS = measure(iterations, legacyStat);
+    double procFileStatNS = measure(iterations, [&statFile]()
+                                    { procFileStat(statFile); });
+    double legacyMemInfoNS = measure(iterations, legacyMemInfo);
+    double procFileMemInfoNS = measure(iterations, [&memInfoFile]()
+                                       { procFileMemInfo(memInfoFile); });
+
+    std::cout << "iterations: " << iterations << "\n";
+    report("/proc/stat (cpu line)", legacyStatNS, procFileStatNS);
+    report("/proc/meminfo (MemTotal, MemAvailable)", legacyMemInfoNS, procFileMemInfoNS);
+
+    return 0;
+}
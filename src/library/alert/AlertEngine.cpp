@@ -0,0 +1,279 @@
+#include "AlertEngine.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+const uint32_t AlertEngine::ALL_SOURCES;
+
+AlertEngine::AlertEngine(const MetricStore &metrics) : metrics(metrics)
+{
+}
+
+int AlertEngine::addVariable(const std::string &name, uint32_t sources)
+{
+    int existing = findVariable(name);
+    if (existing >= 0)
+    {
+        return existing;
+    }
+
+    variableNames.push_back(name);
+    variableSources.push_back(sources);
+    values.push_back(std::numeric_limits<double>::quiet_NaN());
+    return static_cast<int>(values.size()) - 1;
+}
+
+int AlertEngine::findVariable(const std::string &name) const
+{
+    for (size_t i = 0; i < variableNames.size(); i++)
+    {
+        if (variableNames[i] == name)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void AlertEngine::addText(const std::string &name, std::function<std::string()> provider)
+{
+    textNames.push_back(name);
+    texts.push_back(std::move(provider));
+}
+
+AlertSeverity AlertEngine::severityFromName(const std::string &name)
+{
+    return name == "critical" ? ALERT_CRITICAL : name == "info" ? ALERT_INFO : ALERT_WARNING;
+}
+
+/**
+ * @brief Compiles a rule.
+ *
+ * The condition, the optional clear condition and every placeholder of the message
+ * templates are compiled once. A placeholder is a text provider name (`{top_cpu}`) or an
+ * expression with an optional number of decimals (`{cpu:0}`, `{avg(memory, 5m):1}`).
+ * Without a message the rule reports its name and condition; without a resolved message
+ * it reports its name.
+ *
+ * @param rule Rule from `alert_rules` or built from a legacy limit.
+ * @return The rule id, or -1 if the condition or the template does not compile.
+ */
+int AlertEngine::addRule(const AlertRuleStructure &rule)
+{
+    Rule compiled;
+    compiled.name = rule.name;
+    compiled.severity = severityFromName(rule.severity);
+    compiled.hasClear = !rule.clearExpression.empty();
+    compiled.forMS = static_cast<int64_t>(std::max(rule.forSeconds, 0)) * 1000;
+    compiled.renotifyMS = static_cast<int64_t>(std::max(rule.renotifySeconds, 0)) * 1000;
+
+    std::string error;
+    AlertExpression::Resolver resolver = [this](const std::string &name)
+    { return findVariable(name); };
+    if (!compiled.condition.compile(rule.expression, resolver, metrics, error))
+    {
+        logger.logToConsole("Alert rule '" + rule.name + "' ignored: " + error);
+        return -1;
+    }
+    if (compiled.hasClear && !compiled.clear.compile(rule.clearExpression, resolver, metrics, error))
+    {
+        logger.logToConsole("Alert rule '" + rule.name + "' ignored: clear expression " + error);
+        return -1;
+    }
+
+    std::string message = rule.message.empty() ? "Alert: " + rule.name + "\n" + rule.expression : rule.message;
+    if (!compileTemplate(message, compiled.message, error))
+    {
+        logger.logToConsole("Alert rule '" + rule.name + "' ignored: message " + error);
+        return -1;
+    }
+    std::string resolvedMessage = rule.resolvedMessage.empty() ? "Resolved: " + rule.name : rule.resolvedMessage;
+    if (!compileTemplate(resolvedMessage, compiled.resolvedMessage, error))
+    {
+        logger.logToConsole("Alert rule '" + rule.name + "' ignored: resolved message " + error);
+        return -1;
+    }
+
+    compiled.sources = dependencies(compiled.condition);
+    if (compiled.hasClear)
+    {
+        compiled.sources |= dependencies(compiled.clear);
+    }
+
+    rules.push_back(std::move(compiled));
+    states.push_back(AlertState());
+    return static_cast<int>(rules.size()) - 1;
+}
+
+/**
+ * @brief Computes the sources an expression depends on.
+ *
+ * The sources of its variables, and for window functions the sources of the variable named
+ * like the metric (`avg(cpu, 1m)` depends on whatever updates `cpu`). An expression that
+ * reads nothing, or a metric without such a variable, depends on every source.
+ *
+ * @return Mask of sources.
+ */
+uint32_t AlertEngine::dependencies(const AlertExpression &expression) const
+{
+    uint32_t sources = 0;
+    for (int variable : expression.getVariables())
+    {
+        sources |= variableSources[variable];
+    }
+    for (int metric : expression.getMetrics())
+    {
+        int variable = findVariable(metrics.getNames()[metric]);
+        sources |= variable >= 0 ? variableSources[variable] : ALL_SOURCES;
+    }
+    return sources == 0 ? ALL_SOURCES : sources;
+}
+
+bool AlertEngine::compileTemplate(const std::string &text, std::vector<TemplatePart> &parts, std::string &error) const
+{
+    AlertExpression::Resolver resolver = [this](const std::string &name)
+    { return findVariable(name); };
+
+    size_t position = 0;
+    while (position < text.size())
+    {
+        size_t braceOpen = text.find('{', position);
+        TemplatePart literal;
+        literal.kind = TemplatePart::LITERAL;
+        literal.text = text.substr(position, braceOpen == std::string::npos ? std::string::npos : braceOpen - position);
+        if (!literal.text.empty())
+        {
+            parts.push_back(std::move(literal));
+        }
+        if (braceOpen == std::string::npos)
+        {
+            break;
+        }
+
+        size_t braceClose = text.find('}', braceOpen);
+        if (braceClose == std::string::npos)
+        {
+            error = "has an unclosed '{'";
+            return false;
+        }
+
+        std::string placeholder = text.substr(braceOpen + 1, braceClose - braceOpen - 1);
+        TemplatePart part;
+        part.kind = TemplatePart::EXPRESSION;
+        part.decimals = -1;
+        for (size_t i = 0; i < textNames.size(); i++)
+        {
+            if (textNames[i] == placeholder)
+            {
+                part.kind = TemplatePart::TEXT;
+                part.textIndex = static_cast<int>(i);
+            }
+        }
+
+        if (part.kind == TemplatePart::EXPRESSION)
+        {
+            size_t colon = placeholder.rfind(':');
+            if (colon != std::string::npos && colon + 1 < placeholder.size() && placeholder.find_first_not_of("0123456789", colon + 1) == std::string::npos)
+            {
+                part.decimals = std::stoi(placeholder.substr(colon + 1));
+                placeholder.erase(colon);
+            }
+            if (!part.expression.compile(placeholder, resolver, metrics, error))
+            {
+                error = "placeholder {" + placeholder + "}: " + error;
+                return false;
+            }
+        }
+        parts.push_back(std::move(part));
+        position = braceClose + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief Evaluates the rules that depend on new samples and advances their state.
+ *
+ * Rules that read none of `sources` are skipped: their values did not change, and the
+ * time-based parts of their state (for-duration, reminders) advance on their next sample.
+ * Runs the bytecode of the conditions against the current variable values and feeds the
+ * result into the state of the rule (see `AlertState::update`). A firing rule with a clear
+ * expression only evaluates that expression, so it resolves on the clear threshold rather
+ * than as soon as the trigger threshold is no longer met. The loop does not allocate; a few
+ * hundred rules take microseconds.
+ *
+ * @param nowMS Current time, the end of the windows of `avg`, `min` and `max`.
+ * @param sources Mask of the sources with new samples, `ALL_SOURCES` to evaluate every rule.
+ * @param notify Called with the id and the event of every rule that fired, is due for a
+ *               reminder or resolved.
+ */
+void AlertEngine::evaluate(int64_t nowMS, uint32_t sources, const std::function<void(int, AlertEvent)> &notify)
+{
+    const double *variables = values.data();
+    for (size_t rule = 0; rule < rules.size(); rule++)
+    {
+        const Rule &compiled = rules[rule];
+        if (!(compiled.sources & sources))
+        {
+            continue;
+        }
+        AlertState &state = states[rule];
+
+        bool triggered;
+        bool cleared;
+        if (state.phase == ALERT_FIRING && compiled.hasClear)
+        {
+            double result = compiled.clear.evaluate(variables, metrics, nowMS);
+            cleared = result > 0.0 || result < 0.0;
+            triggered = !cleared;
+        }
+        else
+        {
+            double result = compiled.condition.evaluate(variables, metrics, nowMS);
+            triggered = result > 0.0 || result < 0.0;
+            cleared = !triggered;
+        }
+
+        AlertEvent event = state.update(triggered, cleared, nowMS, compiled.forMS, compiled.renotifyMS);
+        if (event != ALERT_NONE)
+        {
+            notify(static_cast<int>(rule), event);
+        }
+    }
+}
+
+std::string AlertEngine::formatMessage(int rule, int64_t nowMS, bool resolved) const
+{
+    std::string text;
+    for (const TemplatePart &part : resolved ? rules[rule].resolvedMessage : rules[rule].message)
+    {
+        if (part.kind == TemplatePart::LITERAL)
+        {
+            text += part.text;
+            continue;
+        }
+        if (part.kind == TemplatePart::TEXT)
+        {
+            text += texts[part.textIndex]();
+            continue;
+        }
+
+        double value = part.expression.evaluate(values.data(), metrics, nowMS);
+        char number[32];
+        if (std::isnan(value))
+        {
+            snprintf(number, sizeof(number), "n/a");
+        }
+        else if (part.decimals >= 0)
+        {
+            snprintf(number, sizeof(number), "%.*f", part.decimals, value);
+        }
+        else
+        {
+            snprintf(number, sizeof(number), value == std::floor(value) ? "%.0f" : "%.1f", value);
+        }
+        text += number;
+    }
+    return text;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include "log/Log.hpp"
+#include "history/MetricStore.hpp"
+#include "alert/AlertExpression.hpp"
+#include "alert/AlertRuleStructure.hpp"
+#include "alert/AlertState.hpp"
+
+enum AlertSeverity
+{
+    ALERT_INFO,
+    ALERT_WARNING,
+    ALERT_CRITICAL
+};
+
+/**
+ * Evaluates alert rules against the latest samples.
+ *
+ * Variables are registered first (by `AlertVariables`) and updated once per tick; rules are
+ * compiled once against them. Every rule has an `AlertState` in a flat array indexed by its
+ * id; `evaluate` walks all rules without allocating and reports state changes (fired,
+ * reminder due, resolved), so a condition that keeps holding is not reported on every tick.
+ * Only formatting the message of a reported rule allocates.
+ *
+ * Variables carry a mask of the sources (collectors) that update them; a rule depends on
+ * the sources of its variables and of the metrics of its window functions, and is only
+ * evaluated when one of those sources has a new sample.
+ */
+class AlertEngine
+{
+public:
+    // Source mask of rules and variables that depend on every source
+    static const uint32_t ALL_SOURCES = 0xffffffffu;
+
+    explicit AlertEngine(const MetricStore &metrics);
+
+    // Registers a variable updated by `sources` (or returns the index of an existing one), before rules are added
+    int addVariable(const std::string &name, uint32_t sources = ALL_SOURCES);
+    void setVariable(int index, double value) { values[index] = value; }
+    int findVariable(const std::string &name) const;
+
+    // Registers a text placeholder for message templates, e.g. "top_cpu"
+    void addText(const std::string &name, std::function<std::string()> provider);
+
+    // Compiles a rule, returns its id or -1 (logged) if the expression or template is invalid
+    int addRule(const AlertRuleStructure &rule);
+
+    // Advances the state of the rules depending on `sources` and calls `notify` for each rule with a due notification
+    void evaluate(int64_t nowMS, uint32_t sources, const std::function<void(int, AlertEvent)> &notify);
+
+    // Renders the message (or resolved message) template of a rule with the current values
+    std::string formatMessage(int rule, int64_t nowMS, bool resolved = false) const;
+
+    const std::string &getRuleName(int rule) const { return rules[rule].name; }
+    AlertSeverity getSeverity(int rule) const { return rules[rule].severity; }
+    const AlertState &getState(int rule) const { return states[rule]; }
+    size_t getRuleCount() const { return rules.size(); }
+
+    static AlertSeverity severityFromName(const std::string &name);
+
+private:
+    // Piece of a message template: literal text, an expression or a text placeholder
+    struct TemplatePart
+    {
+        enum Kind
+        {
+            LITERAL,
+            EXPRESSION,
+            TEXT
+        } kind;
+        std::string text;
+        AlertExpression expression;
+        int decimals;  // -1 prints integers without and other values with one decimal
+        int textIndex; // index into texts
+    };
+
+    struct Rule
+    {
+        std::string name;
+        AlertSeverity severity;
+        uint32_t sources; // sources of the variables and metrics read by the conditions
+        AlertExpression condition;
+        AlertExpression clear; // only compiled if hasClear
+        bool hasClear;
+        int64_t forMS;
+        int64_t renotifyMS;
+        std::vector<TemplatePart> message;
+        std::vector<TemplatePart> resolvedMessage;
+    };
+
+    uint32_t dependencies(const AlertExpression &expression) const;
+    bool compileTemplate(const std::string &text, std::vector<TemplatePart> &parts, std::string &error) const;
+
+    const MetricStore &metrics;
+    std::vector<std::string> variableNames;
+    std::vector<uint32_t> variableSources;
+    std::vector<double> values;
+    std::vector<std::string> textNames;
+    std::vector<std::function<std::string()>> texts;
+    std::vector<Rule> rules;
+    std::vector<AlertState> states; // indexed by rule id
+    Log logger;
+};
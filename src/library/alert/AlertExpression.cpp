@@ -0,0 +1,501 @@
+#include "AlertExpression.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+// Recursive descent parser emitting postfix code
+class AlertExpression::Parser
+{
+public:
+    Parser(const std::string &text, const Resolver &variables, const MetricStore &metrics, AlertExpression &target)
+        : text(text), position(0), depth(0), maxDepth(0), variables(variables), metrics(metrics), target(target)
+    {
+    }
+
+    bool parse(std::string &error)
+    {
+        if (!parseOr())
+        {
+            error = message + " at position " + std::to_string(position);
+            return false;
+        }
+        skipSpaces();
+        if (position != text.size())
+        {
+            error = "unexpected '" + text.substr(position, 1) + "' at position " + std::to_string(position);
+            return false;
+        }
+        if (maxDepth > STACK_SIZE)
+        {
+            error = "expression too deep";
+            return false;
+        }
+        return true;
+    }
+
+private:
+    void skipSpaces()
+    {
+        while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position])))
+        {
+            position++;
+        }
+    }
+
+    bool accept(const char *token)
+    {
+        skipSpaces();
+        size_t length = std::char_traits<char>::length(token);
+        if (text.compare(position, length, token) == 0)
+        {
+            position += length;
+            return true;
+        }
+        return false;
+    }
+
+    bool fail(const std::string &reason)
+    {
+        message = reason;
+        return false;
+    }
+
+    // Tracks the stack depth the code will need: pushes add one, binary operators remove one
+    void emit(OpCode op, int32_t index = 0, double operand = 0.0)
+    {
+        target.code.push_back(Instruction{op, index, operand});
+        if (op == PUSH || op == LOAD || op == WINDOW_AVG || op == WINDOW_MIN || op == WINDOW_MAX)
+        {
+            maxDepth = std::max(maxDepth, ++depth);
+        }
+        else if (op != NEGATE && op != NOT)
+        {
+            depth--;
+        }
+    }
+
+    bool parseOr()
+    {
+        if (!parseAnd())
+        {
+            return false;
+        }
+        while (accept("||"))
+        {
+            if (!parseAnd())
+            {
+                return false;
+            }
+            emit(OR);
+        }
+        return true;
+    }
+
+    bool parseAnd()
+    {
+        if (!parseComparison())
+        {
+            return false;
+        }
+        while (accept("&&"))
+        {
+            if (!parseComparison())
+            {
+                return false;
+            }
+            emit(AND);
+        }
+        return true;
+    }
+
+    bool parseComparison()
+    {
+        if (!parseSum())
+        {
+            return false;
+        }
+
+        // two-character operators first, so "<=" is not read as "<"
+        static const struct
+        {
+            const char *token;
+            OpCode op;
+        } operators[] = {{"<=", LESS_EQUAL}, {">=", GREATER_EQUAL}, {"==", EQUAL}, {"!=", NOT_EQUAL}, {"<", LESS}, {">", GREATER}};
+        for (const auto &entry : operators)
+        {
+            if (accept(entry.token))
+            {
+                if (!parseSum())
+                {
+                    return false;
+                }
+                emit(entry.op);
+                break;
+            }
+        }
+        return true;
+    }
+
+    bool parseSum()
+    {
+        if (!parseProduct())
+        {
+            return false;
+        }
+        while (true)
+        {
+            OpCode op;
+            if (accept("+"))
+            {
+                op = ADD;
+            }
+            else if (accept("-"))
+            {
+                op = SUBTRACT;
+            }
+            else
+            {
+                return true;
+            }
+            if (!parseProduct())
+            {
+                return false;
+            }
+            emit(op);
+        }
+    }
+
+    bool parseProduct()
+    {
+        if (!parseUnary())
+        {
+            return false;
+        }
+        while (true)
+        {
+            OpCode op;
+            if (accept("*"))
+            {
+                op = MULTIPLY;
+            }
+            else if (accept("/"))
+            {
+                op = DIVIDE;
+            }
+            else
+            {
+                return true;
+            }
+            if (!parseUnary())
+            {
+                return false;
+            }
+            emit(op);
+        }
+    }
+
+    bool parseUnary()
+    {
+        if (accept("-"))
+        {
+            if (!parseUnary())
+            {
+                return false;
+            }
+            emit(NEGATE);
+            return true;
+        }
+        // "!" but not "!="
+        skipSpaces();
+        if (position < text.size() && text[position] == '!' && text.compare(position, 2, "!=") != 0)
+        {
+            position++;
+            if (!parseUnary())
+            {
+                return false;
+            }
+            emit(NOT);
+            return true;
+        }
+        return parsePrimary();
+    }
+
+    bool parseIdentifier(std::string &name)
+    {
+        skipSpaces();
+        size_t start = position;
+        while (position < text.size() && (std::isalnum(static_cast<unsigned char>(text[position])) || text[position] == '_' || text[position] == '.'))
+        {
+            position++;
+        }
+        name = text.substr(start, position - start);
+        return !name.empty() && !std::isdigit(static_cast<unsigned char>(name[0]));
+    }
+
+    bool parseNumber(double &value)
+    {
+        skipSpaces();
+        const char *start = text.c_str() + position;
+        char *end = nullptr;
+        value = std::strtod(start, &end);
+        if (end == start)
+        {
+            return false;
+        }
+        position += static_cast<size_t>(end - start);
+        return true;
+    }
+
+    bool parsePrimary()
+    {
+        if (accept("("))
+        {
+            if (!parseOr())
+            {
+                return false;
+            }
+            return accept(")") || fail("missing ')'");
+        }
+
+        skipSpaces();
+        if (position < text.size() && (std::isdigit(static_cast<unsigned char>(text[position])) || text[position] == '.'))
+        {
+            double value;
+            if (!parseNumber(value))
+            {
+                return fail("invalid number");
+            }
+            emit(PUSH, 0, value);
+            return true;
+        }
+
+        std::string name;
+        if (!parseIdentifier(name))
+        {
+            return fail("expected a number, a variable or a function");
+        }
+
+        if (!accept("("))
+        {
+            int index = variables(name);
+            if (index < 0)
+            {
+                return fail("unknown variable '" + name + "'");
+            }
+            emit(LOAD, index);
+            target.variableIndices.push_back(index);
+            return true;
+        }
+
+        OpCode op = name == "avg" ? WINDOW_AVG : name == "min" ? WINDOW_MIN : name == "max" ? WINDOW_MAX : PUSH;
+        if (op == PUSH)
+        {
+            return fail("unknown function '" + name + "'");
+        }
+
+        std::string metric;
+        if (!parseIdentifier(metric))
+        {
+            return fail("expected a metric name");
+        }
+        int id = metrics.find(metric);
+        if (id < 0)
+        {
+            return fail("unknown metric '" + metric + "'");
+        }
+
+        double amount;
+        if (!accept(",") || !parseNumber(amount) || amount <= 0)
+        {
+            return fail("expected a window such as 30s, 5m or 1h");
+        }
+        double unitMS = accept("ms") ? 1.0 : accept("s") ? 1000.0 : accept("m") ? 60000.0 : accept("h") ? 3600000.0 : 1000.0;
+        if (!accept(")"))
+        {
+            return fail("missing ')'");
+        }
+
+        emit(op, id, amount * unitMS);
+        target.metricIds.push_back(id);
+        return true;
+    }
+
+    const std::string &text;
+    size_t position;
+    int depth;
+    int maxDepth;
+    std::string message;
+    const Resolver &variables;
+    const MetricStore &metrics;
+    AlertExpression &target;
+};
+
+AlertExpression::AlertExpression()
+{
+}
+
+/**
+ * @brief Compiles an expression into postfix bytecode.
+ *
+ * Variables and metrics are resolved to indices here, and the needed stack depth is
+ * checked against `STACK_SIZE`, so evaluation never looks up a name and never overflows.
+ *
+ * @param text Expression, e.g. "avg(cpu, 1m) > 85 && mem.available_mb < 512".
+ * @param variables Resolver for variable names.
+ * @param metrics Store whose metrics window functions read.
+ * @param error Receives the reason if the expression is invalid.
+ * @return True if the expression compiled.
+ */
+bool AlertExpression::compile(const std::string &text, const Resolver &variables, const MetricStore &metrics, std::string &error)
+{
+    code.clear();
+    variableIndices.clear();
+    metricIds.clear();
+
+    Parser parser(text, variables, metrics, *this);
+    if (!parser.parse(error))
+    {
+        code.clear();
+        return false;
+    }
+
+    std::sort(variableIndices.begin(), variableIndices.end());
+    variableIndices.erase(std::unique(variableIndices.begin(), variableIndices.end()), variableIndices.end());
+    std::sort(metricIds.begin(), metricIds.end());
+    metricIds.erase(std::unique(metricIds.begin(), metricIds.end()), metricIds.end());
+    code.shrink_to_fit();
+    return true;
+}
+
+// NaN (no data) is false
+static inline bool truth(double value)
+{
+    return value > 0.0 || value < 0.0;
+}
+
+/**
+ * @brief Runs the bytecode on a fixed stack.
+ *
+ * Both operands of `&&` and `||` are always evaluated, which keeps the loop free of jumps;
+ * window functions aggregate the metric's ring in place (`SampleRing::summarizeSince`).
+ * A comparison with a NaN operand yields NaN rather than a boolean, `!` keeps NaN and
+ * `&&`/`||` use three-valued logic (false && NaN is false, true || NaN is true, NaN
+ * otherwise), so neither `x != 0`, `!(x < 90)` nor `!(x > 1 && y > 1)` holds without data.
+ *
+ * @param variables Current variable values, indexed like the resolver used for compiling.
+ * @param metrics Store the expression was compiled against.
+ * @param nowMS Current time, the end of every window.
+ * @return The value of the expression, NaN for an empty expression.
+ */
+double AlertExpression::evaluate(const double *variables, const MetricStore &metrics, int64_t nowMS) const
+{
+    double stack[STACK_SIZE];
+    int top = -1;
+
+    for (const Instruction &instruction : code)
+    {
+        switch (instruction.op)
+        {
+        case PUSH:
+            stack[++top] = instruction.operand;
+            break;
+        case LOAD:
+            stack[++top] = variables[instruction.index];
+            break;
+        case WINDOW_AVG:
+        case WINDOW_MIN:
+        case WINDOW_MAX:
+        {
+            SampleSummary summary;
+            const SampleRing *ring = metrics.getRing(instruction.index);
+            double value = std::numeric_limits<double>::quiet_NaN();
+            if (ring != nullptr && ring->summarizeSince(nowMS - static_cast<int64_t>(instruction.operand), summary))
+            {
+                value = instruction.op == WINDOW_AVG ? summary.sum / summary.count : instruction.op == WINDOW_MIN ? summary.min : summary.max;
+            }
+            stack[++top] = value;
+            break;
+        }
+        case NEGATE:
+            stack[top] = -stack[top];
+            break;
+        case NOT:
+            // a negated comparison without data stays NaN
+            stack[top] = std::isnan(stack[top]) ? stack[top] : truth(stack[top]) ? 0.0 : 1.0;
+            break;
+        default:
+        {
+            double right = stack[top--];
+            double &left = stack[top];
+            if (instruction.op >= LESS && instruction.op <= NOT_EQUAL && (std::isnan(left) || std::isnan(right)))
+            {
+                // no data: neither the comparison nor its negation holds (NaN != x would be true)
+                left = std::numeric_limits<double>::quiet_NaN();
+                break;
+            }
+            switch (instruction.op)
+            {
+            case ADD:
+                left += right;
+                break;
+            case SUBTRACT:
+                left -= right;
+                break;
+            case MULTIPLY:
+                left *= right;
+                break;
+            case DIVIDE:
+                left = right != 0.0 ? left / right : std::numeric_limits<double>::quiet_NaN();
+                break;
+            case LESS:
+                left = left < right;
+                break;
+            case LESS_EQUAL:
+                left = left <= right;
+                break;
+            case GREATER:
+                left = left > right;
+                break;
+            case GREATER_EQUAL:
+                left = left >= right;
+                break;
+            case EQUAL:
+                left = left == right;
+                break;
+            case NOT_EQUAL:
+                left = left != right;
+                break;
+            case AND:
+                // three-valued: false && NaN is false, otherwise NaN stays unknown
+                if ((!std::isnan(left) && !truth(left)) || (!std::isnan(right) && !truth(right)))
+                {
+                    left = 0.0;
+                }
+                else
+                {
+                    left = std::isnan(left) || std::isnan(right) ? std::numeric_limits<double>::quiet_NaN() : 1.0;
+                }
+                break;
+            case OR:
+                // three-valued: true || NaN is true, otherwise NaN stays unknown
+                if (truth(left) || truth(right))
+                {
+                    left = 1.0;
+                }
+                else
+                {
+                    left = std::isnan(left) || std::isnan(right) ? std::numeric_limits<double>::quiet_NaN() : 0.0;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        }
+    }
+
+    return top == 0 ? stack[0] : std::numeric_limits<double>::quiet_NaN();
+}
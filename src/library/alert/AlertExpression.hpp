@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include "history/MetricStore.hpp"
+
+/**
+ * Alert condition compiled to a small stack bytecode.
+ *
+ * Grammar (usual precedence, all values are doubles, true is 1 and false is 0):
+ *
+ *     expression := or
+ *     or         := and ("||" and)*
+ *     and        := comparison ("&&" comparison)*
+ *     comparison := sum (("<" | "<=" | ">" | ">=" | "==" | "!=") sum)?
+ *     sum        := product (("+" | "-") product)*
+ *     product    := unary (("*" | "/") unary)*
+ *     unary      := ("-" | "!") unary | primary
+ *     primary    := number | "(" expression ")" | variable | function "(" metric "," duration ")"
+ *
+ * Functions are `avg`, `min` and `max` of a metric of the `MetricStore` over a recent
+ * window ("30s", "5m", "1h"). Names are resolved while compiling, so evaluation only indexes
+ * arrays. A window without samples yields NaN; a comparison with a NaN operand is NaN as well,
+ * and so are its negation and `&&`/`||` whose result depends on it (three-valued logic).
+ * NaN counts as false, so `!=`, `!` and `!(a && b)` do not fire without data.
+ */
+class AlertExpression
+{
+public:
+    // Resolves a variable name to its index, -1 if unknown
+    typedef std::function<int(const std::string &)> Resolver;
+
+    // Maximum stack depth, deeper expressions are rejected when compiling
+    static const int STACK_SIZE = 32;
+
+    AlertExpression();
+
+    // Compiles `text`, returns false and sets `error` if it is not a valid expression
+    bool compile(const std::string &text, const Resolver &variables, const MetricStore &metrics, std::string &error);
+
+    // Evaluates the expression, does not allocate
+    double evaluate(const double *variables, const MetricStore &metrics, int64_t nowMS) const;
+
+    // Variables read by the expression, sorted and unique
+    const std::vector<int> &getVariables() const { return variableIndices; }
+
+    // Metric ids read by window functions, sorted and unique
+    const std::vector<int> &getMetrics() const { return metricIds; }
+
+private:
+    enum OpCode : uint8_t
+    {
+        PUSH,
+        LOAD,
+        WINDOW_AVG,
+        WINDOW_MIN,
+        WINDOW_MAX,
+        NEGATE,
+        NOT,
+        ADD,
+        SUBTRACT,
+        MULTIPLY,
+        DIVIDE,
+        LESS,
+        LESS_EQUAL,
+        GREATER,
+        GREATER_EQUAL,
+        EQUAL,
+        NOT_EQUAL,
+        AND,
+        OR
+    };
+
+    struct Instruction
+    {
+        OpCode op;
+        int32_t index;  // variable index or metric id
+        double operand; // constant or window length in milliseconds
+    };
+
+    class Parser;
+
+    std::vector<Instruction> code;
+    std::vector<int> variableIndices;
+    std::vector<int> metricIds;
+};
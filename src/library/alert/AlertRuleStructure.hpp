@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+
+struct AlertRuleStructure {
+    std::string name;            // rule name, used in logs
+    std::string expression;      // condition, e.g. "avg(cpu, 1m) > 85 && mem.available_mb < 512"
+    std::string severity;        // "info", "warning" or "critical"
+    std::string message;         // message template with {expression} placeholders, e.g. "CPU {cpu:0}%"
+    std::string clearExpression; // condition that resolves a firing alert, empty for "expression is false"
+    std::string resolvedMessage; // template sent when the alert resolves, empty for a default
+    int forSeconds;              // how long the condition must hold before the alert fires
+    int renotifySeconds;         // interval between reminders while firing, 0 for none, -1 for the default
+};
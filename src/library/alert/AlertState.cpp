@@ -0,0 +1,59 @@
+#include "AlertState.hpp"
+
+/**
+ * @brief Advances the state machine of an alert by one evaluation.
+ *
+ * - inactive: a triggered condition starts the pending phase.
+ * - pending: the alert fires once the condition held for `forMS`; if the condition stops
+ *   holding before, the alert returns to inactive without any notification.
+ * - firing: the alert resolves when the clear condition holds, which may be stricter than
+ *   "not triggered" (hysteresis: trigger at 90%, clear below 85%). While it keeps firing a
+ *   reminder is due every `renotifyMS`.
+ *
+ * @param triggered Whether the alert condition holds.
+ * @param cleared Whether the clear condition holds.
+ * @param forMS Time the condition must hold before the alert fires, 0 to fire at once.
+ * @param renotifyMS Interval of reminders while firing, 0 for none.
+ * @return The notification due, `ALERT_NONE` most of the time.
+ */
+AlertEvent AlertState::update(bool triggered, bool cleared, int64_t nowMS, int64_t forMS, int64_t renotifyMS)
+{
+    switch (phase)
+    {
+    case ALERT_INACTIVE:
+        if (!triggered)
+        {
+            return ALERT_NONE;
+        }
+        phase = ALERT_PENDING;
+        sinceMS = nowMS;
+        // a rule without a for-duration fires on the same evaluation
+        [[fallthrough]];
+    case ALERT_PENDING:
+        if (!triggered)
+        {
+            phase = ALERT_INACTIVE;
+            return ALERT_NONE;
+        }
+        if (nowMS - sinceMS < forMS)
+        {
+            return ALERT_NONE;
+        }
+        phase = ALERT_FIRING;
+        notifiedMS = nowMS;
+        return ALERT_FIRED;
+    case ALERT_FIRING:
+        if (cleared)
+        {
+            phase = ALERT_INACTIVE;
+            return ALERT_RESOLVED;
+        }
+        if (renotifyMS > 0 && nowMS - notifiedMS >= renotifyMS)
+        {
+            notifiedMS = nowMS;
+            return ALERT_REMINDED;
+        }
+        return ALERT_NONE;
+    }
+    return ALERT_NONE;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+enum AlertPhase : uint8_t
+{
+    ALERT_INACTIVE,
+    ALERT_PENDING,
+    ALERT_FIRING
+};
+
+// Notification due after a state update
+enum AlertEvent : uint8_t
+{
+    ALERT_NONE,
+    ALERT_FIRED,
+    ALERT_REMINDED,
+    ALERT_RESOLVED
+};
+
+// State of one alert: inactive -> pending (condition holds) -> firing (held long enough) -> inactive
+struct AlertState
+{
+    AlertPhase phase;
+    int64_t sinceMS;    // start of the pending phase
+    int64_t notifiedMS; // last firing notification
+
+    AlertState() : phase(ALERT_INACTIVE), sinceMS(0), notifiedMS(0) {}
+
+    // Advances the state with the conditions of one evaluation
+    AlertEvent update(bool triggered, bool cleared, int64_t nowMS, int64_t forMS, int64_t renotifyMS);
+};
@@ -0,0 +1,146 @@
+#include "AlertVariables.hpp"
+
+#include <algorithm>
+#include <limits>
+
+AlertVariables::AlertVariables(AlertEngine &engine, CpuMonitor &cpu, MemoryMonitor &memory, PressureMonitor &pressure, DiskMonitor &disk, NetMonitor &net)
+    : engine(engine), cpu(cpu), memory(memory), pressure(pressure), disk(disk), net(net)
+{
+    static const char *names[VARIABLE_COUNT] = {
+        "cpu", "core.hottest", "core.hottest_usage", "core.average", "core.imbalance", "core.longest_hot",
+        "core.longest_hot_seconds", "memory", "mem.total_mb", "mem.available_mb", "swap", "swap.total_mb",
+        "dirty_mb", "commit", "disk.max_util", "disk.max_await_ms", "disk.max_queue", "net.max_rx_mbps",
+        "net.max_tx_mbps", "net.max_errors", "net.max_drops"};
+    for (int variable = 0; variable < VARIABLE_COUNT; variable++)
+    {
+        // `Variable` is grouped by collector
+        SampleSource source = variable < MEMORY            ? SAMPLE_CPU
+                              : variable < DISK_MAX_UTIL   ? SAMPLE_MEMORY
+                              : variable < NET_MAX_RX_MBPS ? SAMPLE_DISK
+                                                           : SAMPLE_NET;
+        indices[variable] = engine.addVariable(names[variable], sampleSourceBit(source));
+    }
+
+    for (int mode = 0; mode < CPU_MODE_COUNT; mode++)
+    {
+        modeIndices[mode] = engine.addVariable(std::string("cpu.") + cpuModeName(mode), sampleSourceBit(SAMPLE_CPU));
+    }
+
+    uint32_t pressureSource = sampleSourceBit(SAMPLE_PRESSURE);
+    for (int resource = 0; resource < PRESSURE_RESOURCE_COUNT; resource++)
+    {
+        std::string prefix = std::string("psi.") + PressureMonitor::resourceName(resource);
+        pressureIndices[resource][0] = engine.addVariable(prefix, pressureSource);
+        pressureIndices[resource][1] = engine.addVariable(prefix + ".avg60", pressureSource);
+        pressureIndices[resource][2] = engine.addVariable(prefix + ".full", pressureSource);
+    }
+}
+
+/**
+ * @brief Copies the values of the last samples into the engine.
+ *
+ * Called once per evaluation with the sources that have new samples; the variables of
+ * other sources keep their values. Every monitor getter returns a copy taken under the
+ * monitor's lock, so the rules of one evaluation see consistent values; device and
+ * interface lists are copied into vectors that keep their capacity between calls.
+ *
+ * @param sources Mask of `sampleSourceBit` of the collectors with new samples.
+ */
+void AlertVariables::update(uint32_t sources)
+{
+    if (sources & sampleSourceBit(SAMPLE_CPU))
+    {
+        updateCpu();
+    }
+    if (sources & sampleSourceBit(SAMPLE_MEMORY))
+    {
+        updateMemory();
+    }
+    if (sources & sampleSourceBit(SAMPLE_PRESSURE))
+    {
+        updatePressure();
+    }
+    if (sources & sampleSourceBit(SAMPLE_DISK))
+    {
+        updateDisk();
+    }
+    if (sources & sampleSourceBit(SAMPLE_NET))
+    {
+        updateNet();
+    }
+}
+
+void AlertVariables::updateCpu()
+{
+    engine.setVariable(indices[CPU], cpu.getLastCpuUsage());
+
+    CpuUsage usage = cpu.getLastCpuBreakdown();
+    for (int mode = 0; mode < CPU_MODE_COUNT; mode++)
+    {
+        engine.setVariable(modeIndices[mode], usage.percent[mode]);
+    }
+
+    CpuCoreSummary cores = cpu.getCoreSummary();
+    engine.setVariable(indices[CORE_HOTTEST], cores.hottestCore);
+    engine.setVariable(indices[CORE_HOTTEST_USAGE], cores.hottestUsage);
+    engine.setVariable(indices[CORE_AVERAGE], cores.averageUsage);
+    engine.setVariable(indices[CORE_IMBALANCE], cores.imbalance);
+    engine.setVariable(indices[CORE_LONGEST_HOT], cores.longestHotCore);
+    engine.setVariable(indices[CORE_LONGEST_HOT_SECONDS], cores.longestHotSeconds);
+}
+
+void AlertVariables::updateMemory()
+{
+    MemInfo info = memory.getLastMemInfo();
+    engine.setVariable(indices[MEMORY], memory.getLastMemoryUsage());
+    engine.setVariable(indices[MEM_TOTAL_MB], info.memTotal / 1024.0);
+    engine.setVariable(indices[MEM_AVAILABLE_MB], info.memAvailable / 1024.0);
+    engine.setVariable(indices[SWAP], info.swapUsagePercent());
+    engine.setVariable(indices[SWAP_TOTAL_MB], info.swapTotal / 1024.0);
+    engine.setVariable(indices[DIRTY_MB], info.dirty / 1024.0);
+    engine.setVariable(indices[COMMIT], info.commitPercent());
+}
+
+void AlertVariables::updatePressure()
+{
+    for (int resource = 0; resource < PRESSURE_RESOURCE_COUNT; resource++)
+    {
+        PressureStats stats = pressure.getStats(resource);
+        double unavailable = std::numeric_limits<double>::quiet_NaN();
+        engine.setVariable(pressureIndices[resource][0], stats.available ? stats.some.avg10 : unavailable);
+        engine.setVariable(pressureIndices[resource][1], stats.available ? stats.some.avg60 : unavailable);
+        engine.setVariable(pressureIndices[resource][2], stats.available ? stats.full.avg10 : unavailable);
+    }
+}
+
+void AlertVariables::updateDisk()
+{
+    double util = 0.0, await = 0.0, queue = 0.0;
+    disk.getStats(diskStats);
+    for (const DiskStats &stats : diskStats)
+    {
+        util = std::max(util, stats.utilPercent);
+        await = std::max(await, stats.awaitMS);
+        queue = std::max(queue, stats.queueDepth);
+    }
+    engine.setVariable(indices[DISK_MAX_UTIL], util);
+    engine.setVariable(indices[DISK_MAX_AWAIT_MS], await);
+    engine.setVariable(indices[DISK_MAX_QUEUE], queue);
+}
+
+void AlertVariables::updateNet()
+{
+    double rx = 0.0, tx = 0.0, errors = 0.0, drops = 0.0;
+    net.getStats(netStats);
+    for (const NetStats &stats : netStats)
+    {
+        rx = std::max(rx, stats.rxBytesPerSec * 8 / 1000000.0);
+        tx = std::max(tx, stats.txBytesPerSec * 8 / 1000000.0);
+        errors = std::max(errors, stats.rxErrorsPerSec + stats.txErrorsPerSec);
+        drops = std::max(drops, stats.rxDropsPerSec + stats.txDropsPerSec);
+    }
+    engine.setVariable(indices[NET_MAX_RX_MBPS], rx);
+    engine.setVariable(indices[NET_MAX_TX_MBPS], tx);
+    engine.setVariable(indices[NET_MAX_ERRORS], errors);
+    engine.setVariable(indices[NET_MAX_DROPS], drops);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+#include "alert/AlertEngine.hpp"
+#include "cpu/CpuMonitor.hpp"
+#include "memory/MemoryMonitor.hpp"
+#include "pressure/PressureMonitor.hpp"
+#include "disk/DiskMonitor.hpp"
+#include "network/NetMonitor.hpp"
+#include "scheduler/SampleEvents.hpp"
+
+/**
+ * Publishes the latest values of the collectors as alert variables.
+ *
+ * Registers one variable per value in the constructor and copies the values of the last
+ * samples into the engine on every `update`:
+ *
+ * - `cpu`, `cpu.<mode>`: CPU usage and the share of every mode, in percent
+ * - `core.hottest`, `core.hottest_usage`, `core.average`, `core.imbalance`,
+ *   `core.longest_hot`, `core.longest_hot_seconds`: per-core summary (core indices, -1 if none)
+ * - `memory`, `mem.total_mb`, `mem.available_mb`, `swap`, `swap.total_mb`, `dirty_mb`, `commit`
+ * - `psi.<resource>`, `psi.<resource>.avg60`, `psi.<resource>.full`: some avg10, some avg60
+ *   and full avg10 stall shares (NaN without PSI)
+ * - `disk.max_util`, `disk.max_await_ms`, `disk.max_queue`: worst block device
+ * - `net.max_rx_mbps`, `net.max_tx_mbps`, `net.max_errors`, `net.max_drops`: worst interface
+ *
+ * Every variable is registered with the `SampleSource` of its collector, so the engine only
+ * evaluates the rules of collectors with new samples.
+ */
+class AlertVariables
+{
+public:
+    AlertVariables(AlertEngine &engine, CpuMonitor &cpu, MemoryMonitor &memory, PressureMonitor &pressure, DiskMonitor &disk, NetMonitor &net);
+
+    // Copies the latest values of the sources in the mask into the engine, allocation-free after the first calls
+    void update(uint32_t sources);
+
+private:
+    enum Variable
+    {
+        CPU,
+        CORE_HOTTEST,
+        CORE_HOTTEST_USAGE,
+        CORE_AVERAGE,
+        CORE_IMBALANCE,
+        CORE_LONGEST_HOT,
+        CORE_LONGEST_HOT_SECONDS,
+        MEMORY,
+        MEM_TOTAL_MB,
+        MEM_AVAILABLE_MB,
+        SWAP,
+        SWAP_TOTAL_MB,
+        DIRTY_MB,
+        COMMIT,
+        DISK_MAX_UTIL,
+        DISK_MAX_AWAIT_MS,
+        DISK_MAX_QUEUE,
+        NET_MAX_RX_MBPS,
+        NET_MAX_TX_MBPS,
+        NET_MAX_ERRORS,
+        NET_MAX_DROPS,
+        VARIABLE_COUNT
+    };
+
+    void updateCpu();
+    void updateMemory();
+    void updatePressure();
+    void updateDisk();
+    void updateNet();
+
+    AlertEngine &engine;
+    CpuMonitor &cpu;
+    MemoryMonitor &memory;
+    PressureMonitor &pressure;
+    DiskMonitor &disk;
+    NetMonitor &net;
+    int indices[VARIABLE_COUNT];
+    int modeIndices[CPU_MODE_COUNT];
+    int pressureIndices[PRESSURE_RESOURCE_COUNT][3];
+    std::vector<DiskStats> diskStats;
+    std::vector<NetStats> netStats;
+};
@@ -0,0 +1,57 @@
+#include "LatencyHistogram.hpp"
+
+LatencyHistogram::LatencyHistogram() : count(0), maxUS(0)
+{
+    for (int bucket = 0; bucket < BUCKETS; bucket++)
+    {
+        counts[bucket] = 0;
+    }
+}
+
+void LatencyHistogram::add(int64_t latencyNS)
+{
+    int64_t us = latencyNS > 0 ? latencyNS / 1000 : 0;
+    int bucket = 0;
+    while (bucket < BUCKETS - 1 && (int64_t(1) << bucket) <= us)
+    {
+        bucket++;
+    }
+
+    counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    if (us > maxUS.load(std::memory_order_relaxed))
+    {
+        maxUS.store(us, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Estimates a quantile of the recorded latencies.
+ *
+ * Walks the buckets up to the rank of `q` and returns the upper bound of that bucket, so
+ * the estimate is at most twice the true value; it never exceeds the largest latency seen.
+ *
+ * @param q Quantile between 0 and 1, e.g. 0.99.
+ * @return Latency in microseconds, 0 if nothing was recorded.
+ */
+int64_t LatencyHistogram::quantileUS(double q) const
+{
+    uint64_t total = getCount();
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(q * (total - 1)) + 1;
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < BUCKETS; bucket++)
+    {
+        seen += counts[bucket].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            int64_t upper = int64_t(1) << bucket;
+            return upper < getMaxUS() ? upper : getMaxUS();
+        }
+    }
+    return getMaxUS();
+}
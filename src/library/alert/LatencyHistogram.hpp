@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Histogram of latencies in power-of-two microsecond buckets.
+ *
+ * Bucket `i` counts latencies below 2^i microseconds (and at least 2^(i-1)), the last bucket
+ * everything from about 18 minutes. Recording is lock-free and allocation-free; readers on
+ * other threads see approximately consistent counts.
+ */
+class LatencyHistogram
+{
+public:
+    static const int BUCKETS = 32;
+
+    LatencyHistogram();
+
+    void add(int64_t latencyNS);
+
+    // Upper bound of the bucket holding quantile `q` (0..1) in microseconds, 0 without samples
+    int64_t quantileUS(double q) const;
+
+    uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+    int64_t getMaxUS() const { return maxUS.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> counts[BUCKETS];
+    std::atomic<uint64_t> count;
+    std::atomic<int64_t> maxUS;
+};
@@ -1,5 +1,7 @@
 #include "App.hpp"
 
+#include <algorithm>
+
 App::App() {}
 
 int App::execute()
@@ -10,21 +12,82 @@ int App::execute()
     nodes.setNodes(settings.getNodeList());
     // nodes.checkUniqueNodes();
 
-    // set monitoring default status
-    this->isMonitoringEnable = this->settings.getDefaultMonitoringStatus();
-
     this->printWelcome();
 
     // Monitoring Objects
-    CpuMonitor cpu(settings.getCpuCheckDuration());
-    MemoryMonitor memory(settings.getMemoryCheckDuration());
-    TelegramMonitor telegram(isMonitoringEnable, cpu, memory, settings, logger);
+    Scheduler scheduler;
+    MetricStore metrics(settings.getHistoryCapacity(), static_cast<size_t>(settings.getHistoryMemoryBudgetMB()) * 1024 * 1024,
+                        settings.getHistoryRetentionHours(), settings.getHistoryPrecision(), settings.getHistoryRollups(),
+                        settings.getHistorySketchResolutionSec(), settings.getHistorySketchRetentionHours());
+    CpuMonitor cpu;
+    MemoryMonitor memory;
+    PressureMonitor pressure;
+    DiskMonitor disk(settings.getDiskCapacity(), settings.getDiskExclude(), settings.getDiskIncludePartitions());
+    NetMonitor net(settings.getNetCapacity(), settings.getNetExclude(), settings.getNetLimits());
+    ProcessMonitor processes(settings.getProcessTopCount());
+    cpu.setCoreHotThreshold(settings.getCoreLimit());
+    cpu.setMetricStore(metrics);
+    memory.setMetricStore(metrics);
+    pressure.setMetricStore(metrics);
+
+    // Persistent history, re-attached from the previous run
+    std::unique_ptr<HistoryFile> historyFile;
+    if (!settings.getHistoryFile().empty())
+    {
+        historyFile.reset(new HistoryFile(settings.getHistoryFile(), static_cast<size_t>(settings.getHistoryFileSegmentKB()) * 1024,
+                                          static_cast<size_t>(settings.getHistoryFileSegments()), settings.getHistoryRollups()));
+        metrics.attachFile(*historyFile);
+    }
+    TelegramMonitor telegram(scheduler, cpu, memory, pressure, disk, net, processes, metrics, settings, logger);
+
+    // Sampling tasks, all executed by the scheduler thread; every sample publishes an event
+    SampleEvents sampleEvents;
+    scheduler.addTask("cpu", settings.getCpuCheckDuration(), [&cpu, &sampleEvents]()
+                      { cpu.sample(); sampleEvents.publish(SAMPLE_CPU); });
+    scheduler.addTask("memory", settings.getMemoryCheckDuration(), [&memory, &sampleEvents]()
+                      { memory.sample(); sampleEvents.publish(SAMPLE_MEMORY); });
+    scheduler.addTask("pressure", settings.getPressureCheckDuration(), [&pressure, &sampleEvents]()
+                      { pressure.sample(); sampleEvents.publish(SAMPLE_PRESSURE); });
+    scheduler.addTask("disk", settings.getDiskCheckDuration(), [&disk, &sampleEvents]()
+                      { disk.sample(); sampleEvents.publish(SAMPLE_DISK); });
+    scheduler.addTask("net", settings.getNetCheckDuration(), [&net, &sampleEvents]()
+                      { net.sample(); sampleEvents.publish(SAMPLE_NET); });
+    scheduler.addTask("processes", settings.getProcessCheckDuration(), [&processes]()
+                      { processes.sample(); });
+
+    // Alert evaluation, right after new samples of the collectors the rules read
+    scheduler.watchFd("samples", sampleEvents.getFd(), POLLIN, [&telegram, &sampleEvents](short)
+                      {
+                          int64_t sampleNS;
+                          uint32_t sources = sampleEvents.consume(sampleNS);
+                          if (sources)
+                          {
+                              telegram.checkUsageLimits(sources, sampleNS);
+                          } });
+
+    // Live dashboard, edited only when its content changed
+    scheduler.addTask("dashboard", std::max(settings.getDashboardIntervalSec(), 1) * 1000, [&telegram]()
+                      { telegram.refreshDashboard(); });
+
+    // Kernel PSI triggers, watched by the scheduler and reported immediately
+    for (const auto &trigger : settings.getPressureTriggers())
+    {
+        pressure.addTrigger(scheduler, trigger);
+    }
+    pressure.setStallHandler([&telegram](const std::string &text)
+                             { telegram.sendAlert(text); });
+
+    // set monitoring default status
+    if (this->settings.getDefaultMonitoringStatus())
+    {
+        scheduler.resume();
+    }
 
     // Start Monitoring
     telegram.startTelegramRequestThread();
 
     // hold app
-    this->hold(cpu, memory, telegram);
+    this->hold(scheduler);
 
     return 0;
 }
@@ -56,25 +119,14 @@ void App::printWelcome()
     this->logger.logToConsole(this->settings.getNodeName());
 }
 
-void App::hold(CpuMonitor &cpu, MemoryMonitor &memory, TelegramMonitor &telegram)
+/**
+ * @brief Runs the sampling scheduler on the main thread.
+ *
+ * All collectors are registered as scheduler tasks and the alert check as a watch of their
+ * sample events, so the main thread is the only sampling thread. Monitoring is enabled and disabled by the
+ * Telegram `/start` and `/stop` commands through `Scheduler::resume` and `Scheduler::pause`.
+ */
+void App::hold(Scheduler &scheduler)
 {
-    while (true)
-    {
-        // Start Monitoring
-        if (this->isMonitoringEnable)
-        {
-            cpu.startMonitoring();
-            memory.startMonitoring();
-            telegram.startTelegramNotificationWatchThread();
-        }
-        // Stop Monitoring
-        if (!this->isMonitoringEnable)
-        {
-            cpu.stopMonitoring();
-            memory.stopMonitoring();
-            telegram.stopTelegramNotificationWatchThread();
-        }
-        sleep(1);
-        continue;
-    }
-}
\ No newline at end of file
+    scheduler.run();
+}
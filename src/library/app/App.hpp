@@ -4,8 +4,15 @@
 #include "settings/Settings.hpp"
 #include "cpu/CpuMonitor.hpp"
 #include "memory/MemoryMonitor.hpp"
+#include "pressure/PressureMonitor.hpp"
+#include "disk/DiskMonitor.hpp"
+#include "network/NetMonitor.hpp"
+#include "process/ProcessMonitor.hpp"
+#include "history/MetricStore.hpp"
 #include "telegram/TelegramMonitor.hpp"
 #include "node/Node.hpp"
+#include "scheduler/Scheduler.hpp"
+#include "scheduler/SampleEvents.hpp"
 
 class App
 {
@@ -19,7 +26,6 @@ private:
     Log logger;
     Settings settings;
     Node nodes;
-    bool isMonitoringEnable;
 
-    void hold(CpuMonitor &cpu, MemoryMonitor &memory, TelegramMonitor &telegram);
+    void hold(Scheduler &scheduler);
 };
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "history/RollupTier.hpp"
+
+/**
+ * Small line chart rasterizer for Telegram replies.
+ *
+ * Draws the min/max band and the average line of rollup buckets on a fixed-size palette
+ * image, with horizontal markers for thresholds, and encodes it with `PngWriter`. Axis
+ * labels are limited to the vertical scale, drawn with a built-in 3x5 digit font.
+ */
+class ChartRenderer
+{
+public:
+    ChartRenderer(int width, int height);
+
+    // Renders the buckets of [sinceMS, untilMS] as PNG, thresholds of 0 or less are not drawn
+    std::string renderPng(const std::vector<RollupBucket> &buckets, int64_t sinceMS, int64_t untilMS,
+                          const std::vector<double> &thresholds);
+
+    // Unicode sparkline ("▁▂▄█") of the bucket averages on a 0..scaleMax scale, `width` characters wide
+    static std::string sparkline(const std::vector<RollupBucket> &buckets, int64_t sinceMS, int64_t untilMS,
+                                 size_t width, double scaleMax);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    enum Color
+    {
+        BACKGROUND,
+        GRID,
+        LABEL,
+        BAND,
+        LINE,
+        THRESHOLD
+    };
+
+    void clear();
+    void plot(int x, int y, uint8_t color);
+    void drawLine(int x0, int y0, int x1, int y1, uint8_t color);
+    void drawNumber(int x, int y, int number, uint8_t color);
+    int toY(double value, double scaleMax) const;
+
+    int width;
+    int height;
+    int plotLeft;
+    int plotTop;
+    int plotRight;
+    int plotBottom;
+    std::vector<uint8_t> pixels;
+};
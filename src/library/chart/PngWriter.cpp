@@ -0,0 +1,77 @@
+#include "PngWriter.hpp"
+
+#include <zlib.h>
+
+/**
+ * @brief Encodes a palette image as PNG.
+ *
+ * The image is written as color type 3 (indexed, 8 bits per pixel): a chart uses a handful
+ * of colors, so one byte per pixel and long runs of the background index deflate to a few
+ * kilobytes. Every row gets filter type 0 (none), which compresses best for flat images.
+ *
+ * @param width Image width in pixels.
+ * @param height Image height in pixels.
+ * @param pixels `width * height` palette indices.
+ * @param palette Up to 256 colors as 0xRRGGBB.
+ * @return The PNG file, or an empty string if compression failed.
+ */
+std::string PngWriter::encodeIndexed(int width, int height, const std::vector<uint8_t> &pixels, const std::vector<uint32_t> &palette)
+{
+    std::string png("\x89PNG\r\n\x1a\n", 8);
+
+    std::string header;
+    appendUInt32(header, static_cast<uint32_t>(width));
+    appendUInt32(header, static_cast<uint32_t>(height));
+    header += std::string("\x08\x03\x00\x00\x00", 5); // depth 8, indexed, deflate, adaptive filtering, no interlace
+    appendChunk(png, "IHDR", header);
+
+    std::string colors;
+    for (uint32_t color : palette)
+    {
+        colors.push_back(static_cast<char>((color >> 16) & 0xFF));
+        colors.push_back(static_cast<char>((color >> 8) & 0xFF));
+        colors.push_back(static_cast<char>(color & 0xFF));
+    }
+    appendChunk(png, "PLTE", colors);
+
+    std::string raw;
+    raw.reserve(static_cast<size_t>(height) * (width + 1));
+    for (int y = 0; y < height; y++)
+    {
+        raw.push_back('\0');
+        raw.append(reinterpret_cast<const char *>(&pixels[static_cast<size_t>(y) * width]), width);
+    }
+
+    uLongf compressedSize = compressBound(static_cast<uLong>(raw.size()));
+    std::string compressed(compressedSize, '\0');
+    if (compress2(reinterpret_cast<Bytef *>(&compressed[0]), &compressedSize, reinterpret_cast<const Bytef *>(raw.data()),
+                  static_cast<uLong>(raw.size()), Z_BEST_SPEED) != Z_OK)
+    {
+        return std::string();
+    }
+    compressed.resize(compressedSize);
+    appendChunk(png, "IDAT", compressed);
+    appendChunk(png, "IEND", std::string());
+
+    return png;
+}
+
+// Chunk layout: length, type, data, CRC-32 of type and data
+void PngWriter::appendChunk(std::string &png, const char *type, const std::string &data)
+{
+    appendUInt32(png, static_cast<uint32_t>(data.size()));
+    size_t typeStart = png.size();
+    png.append(type, 4);
+    png += data;
+
+    uLong crc = crc32(0L, reinterpret_cast<const Bytef *>(png.data() + typeStart), static_cast<uInt>(4 + data.size()));
+    appendUInt32(png, static_cast<uint32_t>(crc));
+}
+
+void PngWriter::appendUInt32(std::string &out, uint32_t value)
+{
+    out.push_back(static_cast<char>((value >> 24) & 0xFF));
+    out.push_back(static_cast<char>((value >> 16) & 0xFF));
+    out.push_back(static_cast<char>((value >> 8) & 0xFF));
+    out.push_back(static_cast<char>(value & 0xFF));
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Minimal PNG encoder for 8-bit palette images, compressed with zlib
+class PngWriter
+{
+public:
+    // Encodes `pixels` (one palette index per pixel, row by row) with a palette of 0xRRGGBB colors
+    static std::string encodeIndexed(int width, int height, const std::vector<uint8_t> &pixels, const std::vector<uint32_t> &palette);
+
+private:
+    static void appendChunk(std::string &png, const char *type, const std::string &data);
+    static void appendUInt32(std::string &out, uint32_t value);
+};
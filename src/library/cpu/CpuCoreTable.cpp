@@ -0,0 +1,115 @@
+#include "CpuCoreTable.hpp"
+
+#include <utility>
+
+/**
+ * @brief Allocates all columns for `capacity` cores.
+ *
+ * No memory is allocated after construction; cores with an index at or above the
+ * capacity are ignored by `parse`.
+ *
+ * @param capacity Number of cores (usually the number of configured processors).
+ */
+CpuCoreTable::CpuCoreTable(int capacity)
+    : capacity(capacity > 0 ? capacity : 1)
+{
+    for (int mode = 0; mode < CPU_MODE_COUNT; mode++)
+    {
+        current[mode].assign(this->capacity, 0);
+        previous[mode].assign(this->capacity, 0);
+    }
+    present.assign(this->capacity, 0);
+    previousPresent.assign(this->capacity, 0);
+    totalDelta.assign(this->capacity, 0);
+    idleDelta.assign(this->capacity, 0);
+    usage.assign(this->capacity, 0.0);
+}
+
+/**
+ * @brief Parses the per-core lines of /proc/stat.
+ *
+ * Reads every line of the form "cpuN user nice system ..." starting at the current
+ * scanner position and stops at the first line that does not start with "cpu".
+ * Offline cores have no line and are marked as not present.
+ *
+ * @param scanner Scanner positioned at the first "cpuN" line.
+ */
+void CpuCoreTable::parse(ProcScanner &scanner)
+{
+    for (int core = 0; core < capacity; core++)
+    {
+        present[core] = 0;
+    }
+
+    while (scanner.match("cpu"))
+    {
+        uint64_t core;
+        if (!scanner.readUInt(core) || core >= static_cast<uint64_t>(capacity))
+        {
+            scanner.nextLine();
+            continue;
+        }
+
+        for (int mode = 0; mode < CPU_MODE_COUNT; mode++)
+        {
+            uint64_t value = 0;
+            scanner.readUInt(value);
+            current[mode][core] = value;
+        }
+        present[core] = 1;
+        scanner.nextLine();
+    }
+}
+
+/**
+ * @brief Computes the busy percentage of every core.
+ *
+ * The deltas are accumulated column by column (one pass per mode over contiguous
+ * arrays), which the compiler can vectorize. A core gets a value only when it was
+ * present in both reads; counters that stepped back (CPU hotplug) yield zero.
+ * Afterwards the current columns become the previous ones by swapping buffers.
+ */
+void CpuCoreTable::update()
+{
+    int64_t *total = totalDelta.data();
+    int64_t *idle = idleDelta.data();
+
+    for (int core = 0; core < capacity; core++)
+    {
+        total[core] = 0;
+        idle[core] = 0;
+    }
+
+    for (int mode = CPU_USER; mode <= CPU_STEAL; mode++)
+    {
+        const uint64_t *now = current[mode].data();
+        const uint64_t *before = previous[mode].data();
+        for (int core = 0; core < capacity; core++)
+        {
+            total[core] += static_cast<int64_t>(now[core] - before[core]);
+        }
+    }
+
+    for (int mode = CPU_IDLE; mode <= CPU_IOWAIT; mode++)
+    {
+        const uint64_t *now = current[mode].data();
+        const uint64_t *before = previous[mode].data();
+        for (int core = 0; core < capacity; core++)
+        {
+            idle[core] += static_cast<int64_t>(now[core] - before[core]);
+        }
+    }
+
+    double *result = usage.data();
+    for (int core = 0; core < capacity; core++)
+    {
+        bool valid = present[core] && previousPresent[core] && total[core] > 0 && idle[core] >= 0 && idle[core] <= total[core];
+        result[core] = valid ? 100.0 * (total[core] - idle[core]) / total[core] : 0.0;
+    }
+
+    for (int mode = 0; mode < CPU_MODE_COUNT; mode++)
+    {
+        std::swap(current[mode], previous[mode]);
+    }
+    std::swap(present, previousPresent);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "proc/ProcScanner.hpp"
+#include "cpu/CpuTimes.hpp"
+
+// Per-core tick counters of /proc/stat stored as structure-of-arrays columns
+class CpuCoreTable
+{
+public:
+    explicit CpuCoreTable(int capacity);
+
+    // Reads the consecutive "cpuN" lines starting at the scanner position
+    void parse(ProcScanner &scanner);
+
+    // Computes per-core busy percentages against the previous parse and keeps the current counters
+    void update();
+
+    int getCapacity() const { return capacity; }
+    const std::vector<double> &getUsage() const { return usage; }
+
+    // Cores present in the last read, valid after update()
+    const std::vector<uint8_t> &getOnline() const { return previousPresent; }
+
+private:
+    int capacity;
+
+    // one column per mode, indexed by core
+    std::vector<uint64_t> current[CPU_MODE_COUNT];
+    std::vector<uint64_t> previous[CPU_MODE_COUNT];
+    std::vector<uint8_t> present;
+    std::vector<uint8_t> previousPresent;
+
+    // scratch columns of update()
+    std::vector<int64_t> totalDelta;
+    std::vector<int64_t> idleDelta;
+
+    std::vector<double> usage;
+};
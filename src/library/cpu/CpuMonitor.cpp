@@ -1,155 +1,303 @@
 #include "CpuMonitor.hpp"
 
-CpuMonitor::CpuMonitor(int durationTimeToCheckMS) : durationTimeToCheckMS(durationTimeToCheckMS), lastCpuUsage(0.0), monitoringCpuStatus(false) {}
+#include <unistd.h>
+#include <cstring>
+#include <algorithm>
 
-/**
- * @brief Starts monitoring the CPU usage.
- *
- * This function initializes a new thread that runs the `thread_getCPUUsage` method.
- * The `thread_getCPUUsage` method will continuously check and record CPU usage in the background.
- * The thread is detached so it continues running independently of the main program flow.
- *
- * The `std::thread` object `monitorThread` is used to handle the concurrent execution of the
- * CPU monitoring task. By detaching the thread, we allow it to run asynchronously, which means
- * it operates in the background and does not block the main program.
- *
- * It is important to ensure that the `thread_getCPUUsage` method is thread-safe and does not
- * access any shared resources without proper synchronization to avoid data races.
- */
-void CpuMonitor::startMonitoring()
+CpuMonitor::CpuMonitor()
+    : lastCpuUsage(0.0),
+      coreCapacity(static_cast<int>(sysconf(_SC_NPROCESSORS_CONF))),
+      statFile("/proc/stat", 4096 + 160 * static_cast<size_t>(coreCapacity > 0 ? coreCapacity : 1)),
+      hasPreviousSample(false),
+      ticksPerSecond(sysconf(_SC_CLK_TCK)),
+      cores(coreCapacity),
+      coreHotThreshold(0.0),
+      coreHotSince(cores.getCapacity()),
+      publishedCoreUsage(cores.getCapacity(), 0.0),
+      metrics(nullptr),
+      usageMetric(-1)
 {
-    // if monitoring enabled
-    if (this->monitoringCpuStatus)
+    std::memset(&previousTimes, 0, sizeof(previousTimes));
+    std::memset(&lastUsage, 0, sizeof(lastUsage));
+    std::memset(&lastCoreSummary, 0, sizeof(lastCoreSummary));
+    lastCoreSummary.hottestCore = -1;
+    lastCoreSummary.longestHotCore = -1;
+    if (ticksPerSecond <= 0)
     {
-        return;
+        ticksPerSecond = 100;
     }
-
-    // if monitoring disabled
-    this->monitoringCpuStatus = true;
-    monitorThread = std::thread(&CpuMonitor::thread_getCPUUsage, this);
-
-    // Detach the thread so it runs in the background
-    monitorThread.detach();
 }
 
 /**
  * @brief Reads CPU time statistics from /proc/stat.
  *
- * This function reads and parses CPU time information from the file `/proc/stat`, which is a
- * virtual file that provides detailed information about the CPU usage.
- *
- * The function extracts the following values:
- * - `user`: Time the CPU has spent in user mode.
- * - `nice`: Time the CPU has spent in user mode with low priority (nice).
- * - `system`: Time the CPU has spent in system mode (kernel).
- * - `idle`: Time the CPU has spent in idle mode.
+ * This function reads and parses the aggregate "cpu" line of `/proc/stat`, which contains the
+ * cumulative time (in clock ticks) all CPUs have spent in each mode:
+ * - `user`, `nice`: Time spent in user mode, with normal and low priority.
+ * - `system`: Time spent in kernel mode.
+ * - `idle`, `iowait`: Time spent idle, without and with outstanding disk I/O.
+ * - `irq`, `softirq`: Time spent servicing hardware and software interrupts.
+ * - `steal`: Time the hypervisor ran other guests while this one wanted to run.
+ * - `guest`, `guest_nice`: Time spent running virtual CPUs of guests (already part of user/nice).
  *
- * It opens the `/proc/stat` file, reads the first line which starts with the label "cpu",
- * and then parses the subsequent values into the provided reference parameters.
+ * Older kernels print fewer columns; missing columns are reported as zero. The "cpuN" lines
+ * that follow the aggregate line are parsed into the per-core table `cores`.
  *
- * If the file cannot be opened, it prints an error message to `std::cerr` and exits the program
- * with a non-zero status code.
+ * The file descriptor of `/proc/stat` stays open for the lifetime of the monitor. Each call
+ * re-reads it with `pread` into the preallocated buffer of `statFile` and parses the line with
+ * `ProcScanner`, so sampling allocates nothing.
  *
- * @param user Reference to a long long where the user CPU time will be stored.
- * @param nice Reference to a long long where the nice CPU time will be stored.
- * @param system Reference to a long long where the system CPU time will be stored.
- * @param idle Reference to a long long where the idle CPU time will be stored.
+ * @param times Structure receiving the tick counters.
+ * @return True if the values were read, false if `/proc/stat` could not be read or parsed.
  */
-void CpuMonitor::readCpuTimes(long long &user, long long &nice, long long &system, long long &idle)
+bool CpuMonitor::readCpuTimes(CpuTimes &times)
 {
-    std::ifstream statFile("/proc/stat");
-    if (!statFile.is_open())
+    if (statFile.read() <= 0)
     {
-        std::cerr << "Error opening /proc/stat" << std::endl;
-        exit(1);
+        std::cerr << "Error reading /proc/stat" << std::endl;
+        return false;
     }
 
-    std::string line;
-    std::getline(statFile, line); // Read the first line (the "cpu" line)
-    std::istringstream iss(line);
-    std::string cpuLabel;
-    iss >> cpuLabel; // Skip the "cpu" label
-    iss >> user >> nice >> system >> idle;
+    ProcScanner scanner(statFile.data(), statFile.size());
+    if (!scanner.match("cpu "))
+    {
+        return false;
+    }
 
-    statFile.close();
+    int mode = 0;
+    for (; mode < CPU_MODE_COUNT; mode++)
+    {
+        if (!scanner.readUInt(times.ticks[mode]))
+        {
+            break;
+        }
+    }
+    if (mode <= CPU_IDLE)
+    {
+        return false;
+    }
+    for (; mode < CPU_MODE_COUNT; mode++)
+    {
+        times.ticks[mode] = 0;
+    }
+
+    scanner.nextLine();
+    cores.parse(scanner);
+
+    return true;
 }
 
 /**
- * @brief Monitors CPU usage in a separate thread.
- *
- * This function continuously monitors the CPU usage in a background thread. It performs the following steps:
- *
- * 1. Checks if monitoring is enabled. If not, it waits for 1 second before checking again.
+ * @brief Takes one CPU usage sample.
  *
- * 2. Reads the initial CPU times from `/proc/stat` using the `readCpuTimes` function.
+ * This function is executed periodically by the `Scheduler` thread. It performs the following steps:
  *
- * 3. Sleeps for a specified period (1 second) to allow time to pass for comparison.
+ * 1. Reads the current CPU times from `/proc/stat` using the `readCpuTimes` function.
  *
- * 4. Reads the CPU times again after the sleep period.
+ * 2. Calculates the difference of every mode to the snapshot kept from the previous sample.
  *
- * 5. Calculates the difference in CPU times to determine the amount of time the CPU was idle and the total CPU time.
- *
- * 6. Computes the CPU usage percentage using the formula:
+ * 3. Computes the busy percentage using the formula:
  *    \[
  *    \text{cpuUsage} = 100.0 \times \frac{(\text{totalDiff} - \text{idleDiff})}{\text{totalDiff}}
  *    \]
- *    where `totalDiff` is the difference in total CPU time and `idleDiff` is the difference in idle time.
+ *    where `totalDiff` is the difference in total CPU time and `idleDiff` is the difference in idle
+ *    and iowait time. The share (`percent`) and the CPU seconds per second (`rate`) of every mode
+ *    are computed from the same differences.
+ *
+ * 4. Updates `lastCpuUsage` and the breakdown, and stores the current snapshot for the next sample.
  *
- * 7. Updates the `lastCpuUsage` variable with the calculated CPU usage percentage.
+ * 5. Updates the per-core usage, see `updateCores`.
  *
- * 8. Sleeps for the duration specified in `this->durationTimeToCheckMS` before repeating the process.
+ * Consecutive samples share their boundaries, so every sample covers the whole period since the
+ * previous one and `/proc/stat` is read only once per period. The very first sample only records
+ * the snapshot. The period is the `cpu_check_duration` setting the task was registered with.
+ */
+void CpuMonitor::sample()
+{
+    CpuTimes times;
+
+    // Read current CPU times
+    if (!readCpuTimes(times))
+    {
+        return;
+    }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    updateCores(now);
+
+    if (hasPreviousSample)
+    {
+        // Calculate differences, counters may step back on CPU hotplug (and iowait on some kernels)
+        uint64_t totalDiff = times.total() > previousTimes.total() ? times.total() - previousTimes.total() : 0;
+        uint64_t idleDiff = times.idle() > previousTimes.idle() ? times.idle() - previousTimes.idle() : 0;
+        double elapsedSeconds = std::chrono::duration<double>(now - previousSampleTime).count();
+
+        if (totalDiff > 0 && elapsedSeconds > 0)
+        {
+            CpuUsage usage;
+            usage.total = idleDiff < totalDiff ? 100.0 * (totalDiff - idleDiff) / totalDiff : 0.0;
+            for (int mode = 0; mode < CPU_MODE_COUNT; mode++)
+            {
+                uint64_t modeDiff = times.ticks[mode] >= previousTimes.ticks[mode] ? times.ticks[mode] - previousTimes.ticks[mode] : 0;
+                usage.percent[mode] = 100.0 * modeDiff / totalDiff;
+                usage.rate[mode] = modeDiff / (ticksPerSecond * elapsedSeconds);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(usageMutex);
+                lastUsage = usage;
+            }
+            lastCpuUsage = usage.total;
+
+            if (metrics != nullptr)
+            {
+                int64_t timeMS = MetricStore::nowMS();
+                metrics->record(usageMetric, timeMS, usage.total);
+                for (int mode = 0; mode < CPU_MODE_COUNT; mode++)
+                {
+                    metrics->record(modeMetrics[mode], timeMS, usage.percent[mode]);
+                }
+            }
+        }
+    }
+
+    // Keep the snapshot for the next sample
+    previousTimes = times;
+    previousSampleTime = now;
+    hasPreviousSample = true;
+}
+
+/**
+ * @brief Records the usage of every sample into a metric store.
  *
- * The function runs in an infinite loop, continuously updating the CPU usage until monitoring is disabled.
+ * Registers "cpu" (busy percentage) and one "cpu.<mode>" metric per mode (share in
+ * percent). Must be called before the scheduler starts.
  *
- * The monitoring interval and CPU check duration are controlled by settings provided to the `CpuMonitor` object.
+ * @param store Store that receives the samples.
  */
-void CpuMonitor::thread_getCPUUsage()
+void CpuMonitor::setMetricStore(MetricStore &store)
 {
-    while (this->monitoringCpuStatus)
+    usageMetric = store.registerMetric("cpu");
+    for (int mode = 0; mode < CPU_MODE_COUNT; mode++)
     {
-        long long user1, nice1, system1, idle1;
-        long long user2, nice2, system2, idle2;
+        modeMetrics[mode] = store.registerMetric(std::string("cpu.") + cpuModeName(mode));
+    }
+    metrics = &store;
+}
 
-        // Read initial CPU times
-        readCpuTimes(user1, nice1, system1, idle1);
+/**
+ * @brief Returns the per-mode breakdown of the last sample.
+ *
+ * @return Copy of the last computed `CpuUsage`, all zero before the second sample.
+ */
+CpuUsage CpuMonitor::getLastCpuBreakdown() const
+{
+    std::lock_guard<std::mutex> lock(usageMutex);
+    return lastUsage;
+}
 
-        // Sleep for a while to get a comparison period
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+/**
+ * @brief Computes per-core usage and hot durations of the current sample.
+ *
+ * The per-core busy percentages are computed by `CpuCoreTable::update`. A core that reaches
+ * `coreHotThreshold` starts a hot period that lasts until it drops below the threshold; the
+ * longest running hot period, the hottest core and the spread between the hottest core and
+ * the average are published in `lastCoreSummary`.
+ *
+ * @param now Time of the current sample.
+ */
+void CpuMonitor::updateCores(std::chrono::steady_clock::time_point now)
+{
+    cores.update();
 
-        // Read CPU times again after the sleep
-        readCpuTimes(user2, nice2, system2, idle2);
+    const std::vector<double> &usage = cores.getUsage();
+    const std::vector<uint8_t> &online = cores.getOnline();
+    double threshold = coreHotThreshold;
 
-        // Calculate differences
-        long long total1 = user1 + nice1 + system1 + idle1;
-        long long total2 = user2 + nice2 + system2 + idle2;
+    CpuCoreSummary summary;
+    std::memset(&summary, 0, sizeof(summary));
+    summary.hottestCore = -1;
+    summary.longestHotCore = -1;
+    double usageSum = 0.0;
+
+    for (int core = 0; core < cores.getCapacity(); core++)
+    {
+        if (!online[core])
+        {
+            coreHotSince[core] = std::chrono::steady_clock::time_point();
+            continue;
+        }
 
-        long long totalDiff = total2 - total1;
-        long long idleDiff = idle2 - idle1;
+        summary.onlineCores++;
+        usageSum += usage[core];
+        if (summary.hottestCore < 0 || usage[core] > summary.hottestUsage)
+        {
+            summary.hottestCore = core;
+            summary.hottestUsage = usage[core];
+        }
 
-        // Calculate CPU usage percentage
-        double cpuUsage = 100.0 * (totalDiff - idleDiff) / totalDiff;
+        if (threshold <= 0 || usage[core] < threshold)
+        {
+            coreHotSince[core] = std::chrono::steady_clock::time_point();
+            continue;
+        }
+        if (coreHotSince[core] == std::chrono::steady_clock::time_point())
+        {
+            coreHotSince[core] = now;
+        }
 
-        // Update the last CPU usage
-        lastCpuUsage = cpuUsage;
+        double hotSeconds = std::chrono::duration<double>(now - coreHotSince[core]).count();
+        if (summary.longestHotCore < 0 || hotSeconds > summary.longestHotSeconds)
+        {
+            summary.longestHotCore = core;
+            summary.longestHotSeconds = hotSeconds;
+        }
+    }
 
-        // Sleep for the CPU check duration from the settings
-        std::this_thread::sleep_for(std::chrono::milliseconds(this->durationTimeToCheckMS));
+    if (summary.onlineCores > 0)
+    {
+        summary.averageUsage = usageSum / summary.onlineCores;
+        summary.imbalance = summary.hottestUsage - summary.averageUsage;
     }
+
+    std::lock_guard<std::mutex> lock(usageMutex);
+    publishedCoreUsage.assign(usage.begin(), usage.end());
+    lastCoreSummary = summary;
 }
 
 /**
- * @brief Stops the CPU monitoring process.
+ * @brief Returns the per-core figures of the last sample.
  *
- * This function sets the `monitoringCpuStatus` flag to `false`,
- * indicating that the CPU monitoring should be stopped. Any ongoing
- * monitoring activities will cease, and the system will no longer
- * collect or process CPU usage data.
+ * @return Copy of the last computed `CpuCoreSummary`.
+ */
+CpuCoreSummary CpuMonitor::getCoreSummary() const
+{
+    std::lock_guard<std::mutex> lock(usageMutex);
+    return lastCoreSummary;
+}
+
+/**
+ * @brief Returns the busiest cores of the last sample.
  *
- * This method should be called when monitoring is no longer needed
- * to ensure that resources are released and the monitoring process
- * is gracefully terminated.
+ * @param count Maximum number of cores to return.
+ * @return Pairs of (core index, usage percentage), busiest first.
  */
-void CpuMonitor::stopMonitoring()
+std::vector<std::pair<int, double>> CpuMonitor::getTopCores(int count) const
 {
-    this->monitoringCpuStatus = false;
-}
\ No newline at end of file
+    std::vector<std::pair<int, double>> top;
+    {
+        std::lock_guard<std::mutex> lock(usageMutex);
+        top.reserve(publishedCoreUsage.size());
+        for (size_t core = 0; core < publishedCoreUsage.size(); core++)
+        {
+            top.push_back(std::make_pair(static_cast<int>(core), publishedCoreUsage[core]));
+        }
+    }
+
+    size_t limit = count > 0 ? std::min(static_cast<size_t>(count), top.size()) : 0;
+    std::partial_sort(top.begin(), top.begin() + limit, top.end(),
+                      [](const std::pair<int, double> &a, const std::pair<int, double> &b)
+                      { return a.second > b.second; });
+    top.resize(limit);
+    return top;
+}
@@ -1,36 +1,88 @@
 #pragma once
 
 #include <iostream>
-#include <fstream>
-#include <sstream>
-#include <thread>
 #include <chrono>
 #include <atomic>
+#include <mutex>
+#include <vector>
+#include <utility>
 #include "settings/Settings.hpp"
+#include "proc/ProcFile.hpp"
+#include "proc/ProcScanner.hpp"
+#include "cpu/CpuTimes.hpp"
+#include "cpu/CpuCoreTable.hpp"
+#include "history/MetricStore.hpp"
+
+// Per-core figures of the last sample
+struct CpuCoreSummary
+{
+    int onlineCores;
+    int hottestCore;
+    double hottestUsage;
+    double averageUsage;
+
+    // Percentage points between the hottest core and the average of all cores
+    double imbalance;
+
+    // Core that has been above the hot threshold for the longest time
+    int longestHotCore;
+    double longestHotSeconds;
+};
 
 class CpuMonitor
 {
 public:
-    CpuMonitor(int durationTimeToCheckMS);
+    CpuMonitor();
 
-    // Starts the thread to monitor CPU usage
-    void startMonitoring();
-    
-    // Stop the thread to monitor CPU usage
-    void stopMonitoring();
+    // Takes one CPU usage sample, called periodically by the scheduler
+    void sample();
 
     // Gets the last recorded CPU usage
     double getLastCpuUsage() const { return lastCpuUsage; }
 
+    // Gets the per-mode breakdown (user, iowait, steal, ...) of the last sample
+    CpuUsage getLastCpuBreakdown() const;
+
+    // Usage above which a core counts as hot, 0 disables hot tracking
+    void setCoreHotThreshold(double threshold) { coreHotThreshold = threshold; }
+
+    // Gets per-core figures of the last sample
+    CpuCoreSummary getCoreSummary() const;
+
+    // Gets the `count` busiest cores of the last sample as (core, usage) pairs
+    std::vector<std::pair<int, double>> getTopCores(int count) const;
+
+    // Registers "cpu" and "cpu.<mode>" and records every sample into the store
+    void setMetricStore(MetricStore &store);
+
 private:
-    // Function that runs in a thread to get CPU usage
-    void thread_getCPUUsage();
+    // Reads aggregate and per-core CPU times from /proc/stat
+    bool readCpuTimes(CpuTimes &times);
 
-    // Reads CPU times from /proc/stat
-    void readCpuTimes(long long &user, long long &nice, long long &system, long long &idle);
+    // Updates hot durations and the published per-core values
+    void updateCores(std::chrono::steady_clock::time_point now);
 
-    bool monitoringCpuStatus;
-    int durationTimeToCheckMS;
     std::atomic<double> lastCpuUsage;
-    std::thread monitorThread;
+    CpuUsage lastUsage;
+    mutable std::mutex usageMutex;
+    int coreCapacity;
+    ProcFile statFile;
+
+    // Snapshot of the previous sample
+    bool hasPreviousSample;
+    CpuTimes previousTimes;
+    std::chrono::steady_clock::time_point previousSampleTime;
+    long ticksPerSecond;
+
+    // Per-core state
+    CpuCoreTable cores;
+    std::atomic<double> coreHotThreshold;
+    std::vector<std::chrono::steady_clock::time_point> coreHotSince;
+    std::vector<double> publishedCoreUsage;
+    CpuCoreSummary lastCoreSummary;
+
+    // History, recorded when a store is set
+    MetricStore *metrics;
+    int usageMetric;
+    int modeMetrics[CPU_MODE_COUNT];
 };
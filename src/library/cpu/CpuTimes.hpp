@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// Columns of a "cpu" line in /proc/stat, in file order
+enum CpuMode
+{
+    CPU_USER = 0,
+    CPU_NICE,
+    CPU_SYSTEM,
+    CPU_IDLE,
+    CPU_IOWAIT,
+    CPU_IRQ,
+    CPU_SOFTIRQ,
+    CPU_STEAL,
+    CPU_GUEST,
+    CPU_GUEST_NICE,
+    CPU_MODE_COUNT
+};
+
+// Name of a mode as used in settings and messages ("user", "iowait", "steal", ...)
+inline const char *cpuModeName(int mode)
+{
+    static const char *names[CPU_MODE_COUNT] = {
+        "user", "nice", "system", "idle", "iowait", "irq", "softirq", "steal", "guest", "guest_nice"};
+    return (mode >= 0 && mode < CPU_MODE_COUNT) ? names[mode] : "";
+}
+
+// Mode index for a name, or -1 if the name is unknown
+inline int cpuModeFromName(const char *name)
+{
+    for (int mode = 0; mode < CPU_MODE_COUNT; mode++)
+    {
+        if (std::strcmp(cpuModeName(mode), name) == 0)
+        {
+            return mode;
+        }
+    }
+    return -1;
+}
+
+// Cumulative tick counters of one "cpu" line
+struct CpuTimes
+{
+    uint64_t ticks[CPU_MODE_COUNT];
+
+    // guest and guest_nice are already accounted in user and nice
+    uint64_t total() const
+    {
+        uint64_t sum = 0;
+        for (int mode = CPU_USER; mode <= CPU_STEAL; mode++)
+        {
+            sum += ticks[mode];
+        }
+        return sum;
+    }
+
+    // Time the CPU was not executing anything
+    uint64_t idle() const { return ticks[CPU_IDLE] + ticks[CPU_IOWAIT]; }
+};
+
+// Usage derived from two CpuTimes snapshots
+struct CpuUsage
+{
+    // Busy percentage (everything except idle and iowait)
+    double total;
+
+    // Share of each mode in the interval, in percent
+    double percent[CPU_MODE_COUNT];
+
+    // Time spent in each mode per second of wall time, in CPU seconds
+    double rate[CPU_MODE_COUNT];
+};
@@ -0,0 +1,241 @@
+#include "DiskMonitor.hpp"
+
+#include <fnmatch.h>
+#include <unistd.h>
+#include <cstring>
+
+/**
+ * @brief Allocates the fixed device table.
+ *
+ * Every block device gets one slot of the table the first time it shows up in
+ * `/proc/diskstats`. Slots of devices that disappear are released and reused by new
+ * devices, so hot-plugged disks and short-lived devices never cause a reallocation.
+ *
+ * @param capacity Maximum number of devices tracked at the same time.
+ * @param excludePatterns Shell patterns (`fnmatch`) of device names to ignore, e.g. "loop*".
+ * @param includePartitions Whether partitions are monitored next to whole disks.
+ */
+DiskMonitor::DiskMonitor(int capacity, const std::vector<std::string> &excludePatterns, bool includePartitions)
+    : records(capacity > 0 ? capacity : 1), excludePatterns(excludePatterns), includePartitions(includePartitions),
+      diskStatsFile("/proc/diskstats", 65536), hasPreviousSample(false), capacityWarned(false)
+{
+    for (DiskRecord &record : records)
+    {
+        std::memset(&record, 0, sizeof(record));
+    }
+}
+
+/**
+ * @brief Reads /proc/diskstats and derives the rates of every device.
+ *
+ * Each line holds "major minor name" followed by cumulative counters:
+ *
+ *     8 0 sda 4870 1204 394754 3211 9128 7341 470528 25711 0 12108 28922 ...
+ *
+ * The file is parsed in one pass with `ProcScanner`; the name of each line is looked up
+ * in the device table and its counters are compared with the previous sample (see
+ * `derive`). Devices that were not present in this read release their slot.
+ */
+void DiskMonitor::sample()
+{
+    if (diskStatsFile.read() <= 0)
+    {
+        logger.logToConsole("Error reading /proc/diskstats");
+        return;
+    }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double elapsedSeconds = hasPreviousSample ? std::chrono::duration<double>(now - previousSampleTime).count() : 0.0;
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+
+    for (DiskRecord &record : records)
+    {
+        record.seen = false;
+    }
+
+    ProcScanner scanner(diskStatsFile.data(), diskStatsFile.size());
+    while (!scanner.atEnd())
+    {
+        uint64_t major, minor;
+        const char *name;
+        size_t length;
+        if (!scanner.readUInt(major) || !scanner.readUInt(minor) || !scanner.readToken(name, length) || length >= sizeof(DiskRecord::name))
+        {
+            scanner.nextLine();
+            continue;
+        }
+
+        int index = findRecord(name, length);
+        if (index < 0)
+        {
+            if (!capacityWarned)
+            {
+                logger.logToConsole("Disk table is full, some devices are not monitored");
+                capacityWarned = true;
+            }
+            scanner.nextLine();
+            continue;
+        }
+
+        DiskRecord &record = records[index];
+        record.seen = true;
+        if (record.ignored)
+        {
+            scanner.nextLine();
+            continue;
+        }
+
+        uint64_t counters[COUNTER_COUNT] = {};
+        for (int counter = 0; counter < COUNTER_COUNT; counter++)
+        {
+            scanner.readUInt(counters[counter]);
+        }
+        derive(record, counters, elapsedSeconds);
+        scanner.nextLine();
+    }
+
+    // release slots of devices that disappeared
+    for (DiskRecord &record : records)
+    {
+        if (record.used && !record.seen)
+        {
+            record.used = false;
+        }
+    }
+
+    previousSampleTime = now;
+    hasPreviousSample = true;
+}
+
+/**
+ * @brief Returns the rates of all monitored devices.
+ *
+ * @return One entry per present, not ignored device that has been sampled at least twice.
+ */
+std::vector<DiskStats> DiskMonitor::getStats() const
+{
+    std::vector<DiskStats> result;
+    getStats(result);
+    return result;
+}
+
+void DiskMonitor::getStats(std::vector<DiskStats> &out) const
+{
+    out.clear();
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    for (const DiskRecord &record : records)
+    {
+        if (record.used && !record.ignored && record.hasPrevious)
+        {
+            out.push_back(record.stats);
+        }
+    }
+}
+
+/**
+ * @brief Finds the slot of a device, or assigns a free one to a new device.
+ *
+ * New devices are checked against the exclude patterns and the partition rule once, and
+ * the result is kept in the slot.
+ *
+ * @return The slot index, or -1 if the table is full.
+ */
+int DiskMonitor::findRecord(const char *name, size_t length)
+{
+    int freeIndex = -1;
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const DiskRecord &record = records[i];
+        if (!record.used)
+        {
+            if (freeIndex < 0)
+            {
+                freeIndex = static_cast<int>(i);
+            }
+            continue;
+        }
+        if (record.nameLength == length && std::memcmp(record.name, name, length) == 0)
+        {
+            return static_cast<int>(i);
+        }
+    }
+
+    if (freeIndex < 0)
+    {
+        return -1;
+    }
+
+    DiskRecord &record = records[freeIndex];
+    std::memset(&record, 0, sizeof(record));
+    record.used = true;
+    std::memcpy(record.name, name, length);
+    record.name[length] = '\0';
+    record.nameLength = length;
+    std::memcpy(record.stats.name, record.name, sizeof(record.stats.name));
+    record.ignored = isIgnored(record.name);
+
+    return freeIndex;
+}
+
+bool DiskMonitor::isIgnored(const char *name) const
+{
+    for (const std::string &pattern : excludePatterns)
+    {
+        if (fnmatch(pattern.c_str(), name, 0) == 0)
+        {
+            return true;
+        }
+    }
+
+    if (!includePartitions)
+    {
+        std::string partitionPath = std::string("/sys/class/block/") + name + "/partition";
+        if (access(partitionPath.c_str(), F_OK) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Derives the rates of a device from the counter deltas.
+ *
+ * With `dt` the elapsed time and Δ the counter differences:
+ * - IOPS = Δreads / dt and Δwrites / dt
+ * - throughput = Δsectors × 512 / dt (diskstats sectors are always 512 bytes)
+ * - await = (Δms reading + Δms writing) / (Δreads + Δwrites)
+ * - utilization = Δms doing I/O / (dt × 1000) × 100
+ * - queue depth = Δweighted ms doing I/O / (dt × 1000)
+ *
+ * The first sample of a device only stores its counters.
+ */
+void DiskMonitor::derive(DiskRecord &record, const uint64_t *counters, double elapsedSeconds)
+{
+    if (record.hasPrevious && elapsedSeconds > 0)
+    {
+        uint64_t delta[COUNTER_COUNT];
+        for (int counter = 0; counter < COUNTER_COUNT; counter++)
+        {
+            // counters are reset when a device is re-created under the same name
+            delta[counter] = counters[counter] >= record.counters[counter] ? counters[counter] - record.counters[counter] : 0;
+        }
+
+        double elapsedMS = elapsedSeconds * 1000.0;
+        uint64_t requests = delta[READS] + delta[WRITES];
+
+        record.stats.readIops = delta[READS] / elapsedSeconds;
+        record.stats.writeIops = delta[WRITES] / elapsedSeconds;
+        record.stats.readBytesPerSec = delta[SECTORS_READ] * 512.0 / elapsedSeconds;
+        record.stats.writeBytesPerSec = delta[SECTORS_WRITTEN] * 512.0 / elapsedSeconds;
+        record.stats.awaitMS = requests ? static_cast<double>(delta[MS_READING] + delta[MS_WRITING]) / requests : 0.0;
+        record.stats.utilPercent = delta[MS_IO] >= elapsedMS ? 100.0 : 100.0 * delta[MS_IO] / elapsedMS;
+        record.stats.queueDepth = delta[WEIGHTED_MS_IO] / elapsedMS;
+    }
+
+    std::memcpy(record.counters, counters, sizeof(record.counters));
+    record.hasPrevious = true;
+}
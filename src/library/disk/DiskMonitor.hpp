@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include "log/Log.hpp"
+#include "proc/ProcFile.hpp"
+#include "proc/ProcScanner.hpp"
+
+// Rates of one block device, derived from two /proc/diskstats samples
+struct DiskStats
+{
+    char name[32];
+    double readIops;
+    double writeIops;
+    double readBytesPerSec;
+    double writeBytesPerSec;
+
+    // Average time per completed request (queue + service), in milliseconds
+    double awaitMS;
+
+    // Share of time with at least one request in flight, in percent
+    double utilPercent;
+
+    // Average number of requests in flight
+    double queueDepth;
+};
+
+class DiskMonitor
+{
+public:
+    DiskMonitor(int capacity, const std::vector<std::string> &excludePatterns, bool includePartitions);
+
+    // Reads /proc/diskstats and derives rates, called periodically by the scheduler
+    void sample();
+
+    // Gets the rates of all monitored devices of the last sample
+    std::vector<DiskStats> getStats() const;
+
+    // Same into a reused vector, allocation-free once its capacity fits all devices
+    void getStats(std::vector<DiskStats> &out) const;
+
+private:
+    // Columns of /proc/diskstats used for the derivation
+    enum Counter
+    {
+        READS = 0,
+        READS_MERGED,
+        SECTORS_READ,
+        MS_READING,
+        WRITES,
+        WRITES_MERGED,
+        SECTORS_WRITTEN,
+        MS_WRITING,
+        IOS_IN_PROGRESS,
+        MS_IO,
+        WEIGHTED_MS_IO,
+        COUNTER_COUNT
+    };
+
+    struct DiskRecord
+    {
+        bool used;        // slot holds a device
+        bool seen;        // device was present in the current read
+        bool ignored;     // filtered out by pattern or partition rule
+        bool hasPrevious; // counters hold a previous sample
+        char name[32];
+        size_t nameLength;
+        uint64_t counters[COUNTER_COUNT];
+        DiskStats stats;
+    };
+
+    int findRecord(const char *name, size_t length);
+    bool isIgnored(const char *name) const;
+    void derive(DiskRecord &record, const uint64_t *counters, double elapsedSeconds);
+
+    std::vector<DiskRecord> records;
+    std::vector<std::string> excludePatterns;
+    bool includePartitions;
+    ProcFile diskStatsFile;
+    std::chrono::steady_clock::time_point previousSampleTime;
+    bool hasPreviousSample;
+    bool capacityWarned;
+    mutable std::mutex statsMutex;
+    Log logger;
+};
@@ -0,0 +1,125 @@
+#include "CompressedSeries.hpp"
+
+#include <algorithm>
+
+/**
+ * @param samplesPerChunk Samples per chunk before it is sealed; larger chunks compress
+ *                        slightly better but are dropped in coarser steps.
+ * @param retentionMS Age after which a sealed chunk is dropped.
+ */
+CompressedSeries::CompressedSeries(size_t samplesPerChunk, int64_t retentionMS)
+    : samplesPerChunk(samplesPerChunk > 0 ? samplesPerChunk : 1), retentionMS(retentionMS)
+{
+}
+
+/**
+ * @brief Appends a sample to the open chunk.
+ *
+ * A full open chunk is sealed: it becomes immutable and is shared with readers by
+ * pointer, so reading a long window never copies sealed chunks. Sealed chunks whose last
+ * sample is older than the retention are dropped.
+ */
+void CompressedSeries::append(int64_t timeMS, double value)
+{
+    std::lock_guard<std::mutex> lock(chunksMutex);
+
+    openChunk.append(timeMS, value);
+    if (openChunk.getCount() < samplesPerChunk)
+    {
+        return;
+    }
+
+    openChunk.shrinkToFit();
+    sealedChunks.push_back(std::make_shared<const GorillaChunk>(std::move(openChunk)));
+    openChunk = GorillaChunk();
+
+    while (!sealedChunks.empty() && sealedChunks.front()->getLastTime() < timeMS - retentionMS)
+    {
+        sealedChunks.pop_front();
+    }
+}
+
+/**
+ * @brief Decompresses the samples of a time window.
+ *
+ * Sealed chunks are ordered by time, so the chunks of the window are found by a binary
+ * search on their start times and chunks outside the window are never touched, let alone
+ * decoded. Only the chunk pointers and the (small) open chunk are copied under the lock;
+ * the decompression runs without it, so a long read never delays the sampler.
+ *
+ * @return Number of samples appended to `out`.
+ */
+size_t CompressedSeries::read(int64_t sinceMS, int64_t untilMS, std::vector<Sample> &out) const
+{
+    std::vector<std::shared_ptr<const GorillaChunk>> chunks;
+    GorillaChunk open;
+    {
+        std::lock_guard<std::mutex> lock(chunksMutex);
+        // first chunk starting after the window, then back to the chunk that contains sinceMS
+        auto startsAfter = [](int64_t timeMS, const std::shared_ptr<const GorillaChunk> &chunk)
+        { return timeMS < chunk->getFirstTime(); };
+        auto last = std::upper_bound(sealedChunks.begin(), sealedChunks.end(), untilMS, startsAfter);
+        auto first = std::upper_bound(sealedChunks.begin(), last, sinceMS, startsAfter);
+        if (first != sealedChunks.begin())
+        {
+            --first;
+        }
+        for (auto chunk = first; chunk != last; ++chunk)
+        {
+            if ((*chunk)->getLastTime() >= sinceMS)
+            {
+                chunks.push_back(*chunk);
+            }
+        }
+        if (openChunk.getCount() > 0 && openChunk.getLastTime() >= sinceMS && openChunk.getFirstTime() <= untilMS)
+        {
+            open = openChunk;
+        }
+    }
+    if (open.getCount() > 0)
+    {
+        chunks.push_back(std::make_shared<const GorillaChunk>(std::move(open)));
+    }
+
+    size_t start = out.size();
+    for (const auto &chunk : chunks)
+    {
+        GorillaChunk::Iterator iterator = chunk->iterate();
+        Sample sample;
+        while (iterator.next(sample))
+        {
+            if (sample.timeMS > untilMS)
+            {
+                break;
+            }
+            if (sample.timeMS >= sinceMS)
+            {
+                out.push_back(sample);
+            }
+        }
+    }
+
+    return out.size() - start;
+}
+
+size_t CompressedSeries::getSizeBytes() const
+{
+    std::lock_guard<std::mutex> lock(chunksMutex);
+    size_t bytes = openChunk.getSizeBytes();
+    for (const auto &chunk : sealedChunks)
+    {
+        bytes += chunk->getSizeBytes();
+    }
+    return bytes;
+}
+
+size_t CompressedSeries::getCount() const
+{
+    std::lock_guard<std::mutex> lock(chunksMutex);
+    size_t samples = openChunk.getCount();
+    for (const auto &chunk : sealedChunks)
+    {
+        samples += chunk->getCount();
+    }
+    return samples;
+}
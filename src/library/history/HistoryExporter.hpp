@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include "log/Log.hpp"
+#include "history/MetricStore.hpp"
+
+/**
+ * Writes metric history to a file, streamed block by block from a `MetricStore`.
+ *
+ * Two formats are supported:
+ * - CSV, one row per metric and bucket: `metric,time_ms,min,avg,max,count`
+ * - a binary columnar format (see `writeColumnar`) that is about 2.5 times smaller and much faster to write and parse
+ */
+class HistoryExporter
+{
+public:
+    enum Format
+    {
+        CSV,
+        COLUMNAR
+    };
+
+    explicit HistoryExporter(const MetricStore &metrics);
+
+    // Writes the buckets of [sinceMS, untilMS] of the given metrics, returns the number of rows
+    // or -1 if the file could not be written
+    long long write(const std::string &path, Format format, const std::vector<int> &ids, int64_t sinceMS, int64_t untilMS);
+
+    // Buckets held in memory at a time, per metric
+    static const size_t BLOCK_ROWS = 4096;
+
+private:
+    long long writeCsv(FILE *file, const std::vector<int> &ids, int64_t sinceMS, int64_t untilMS);
+    long long writeColumnar(FILE *file, const std::vector<int> &ids, int64_t sinceMS, int64_t untilMS);
+    int64_t stepOf(int id) const;
+
+    const MetricStore &metrics;
+    Log logger;
+};
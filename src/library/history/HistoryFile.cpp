@@ -0,0 +1,438 @@
+#include "HistoryFile.hpp"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <cstddef>
+
+static const char HISTORY_MAGIC[8] = {'L', 'M', 'H', 'I', 'S', 'T', '\0', '\0'};
+static const uint32_t SEGMENT_MAGIC = 0x5345474d; // "SEGM"
+static const size_t PAGE = 4096;
+
+static size_t roundToPage(size_t size)
+{
+    return (size + PAGE - 1) / PAGE * PAGE;
+}
+
+// CRC-32 (IEEE), table built on first use
+static uint32_t crc32(uint32_t crc, const void *data, size_t length)
+{
+    static uint32_t table[256];
+    static bool initialized = false;
+    if (!initialized)
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            }
+            table[i] = value;
+        }
+        initialized = true;
+    }
+
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/**
+ * @brief Maps the history file, creating or re-attaching it.
+ *
+ * An existing file with a valid header and the same geometry is re-attached as it is: the
+ * write position is read from the header cursor and only the records around it are checked
+ * (see `recover`), so attaching costs the same for an empty and for a full file. A missing
+ * file, a file with another version or geometry, or a corrupt header is reinitialized.
+ *
+ * If the file cannot be created or mapped, `isOpen()` returns false and the monitor runs
+ * without persistent history.
+ *
+ * @param path File path (`history_file`).
+ * @param segmentSize Bytes per segment, rounded up to a page (`history_file_segment_kb`).
+ * @param segmentCount Number of segments in the ring (`history_file_segments`).
+ * @param rollups Rollup tiers kept in the file (`history_rollups`), at most MAX_ROLLUPS;
+ *                the geometry matches the tiers `MetricStore` allocates for them.
+ */
+HistoryFile::HistoryFile(const std::string &path, size_t segmentSize, size_t segmentCount, const std::vector<RollupTierStructure> &rollups)
+    : path(path), segmentSize(roundToPage(std::max(segmentSize, PAGE))), segmentCount(std::max<size_t>(segmentCount, 2)),
+      rollupOffset(0), rollupMetricBytes(0), fileSize(0), fd(-1), base(nullptr), currentSegment(0), currentRecord(0), currentSequence(0)
+{
+    for (const RollupTierStructure &rollup : rollups)
+    {
+        if (this->rollups.size() < MAX_ROLLUPS)
+        {
+            // the same geometry as the RollupTier of this rollup
+            int64_t resolutionMS = std::max<int64_t>(static_cast<int64_t>(rollup.resolutionSec) * 1000, 1);
+            uint64_t bucketCount = static_cast<uint64_t>(std::max<int64_t>(static_cast<int64_t>(rollup.retentionHours) * 3600 * 1000 / resolutionMS, 1));
+            this->rollups.push_back(std::make_pair(resolutionMS, bucketCount));
+            rollupMetricBytes += static_cast<size_t>(bucketCount) * sizeof(RollupBucket);
+        }
+    }
+    rollupOffset = roundToPage(sizeof(Header)) + this->segmentSize * this->segmentCount;
+    fileSize = rollupOffset + roundToPage(rollupMetricBytes * MAX_ROLLUP_METRICS);
+
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        logger.logToConsole("Failed to open history file " + path + ": " + std::strerror(errno));
+        return;
+    }
+
+    struct stat status;
+    bool existing = fstat(fd, &status) == 0 && static_cast<size_t>(status.st_size) == fileSize;
+    if (!existing && ftruncate(fd, static_cast<off_t>(fileSize)) != 0)
+    {
+        logger.logToConsole("Failed to resize history file " + path + ": " + std::strerror(errno));
+        close(fd);
+        fd = -1;
+        return;
+    }
+
+    void *mapping = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        logger.logToConsole("Failed to map history file " + path + ": " + std::strerror(errno));
+        close(fd);
+        fd = -1;
+        return;
+    }
+    base = static_cast<char *>(mapping);
+
+    if (existing && validHeader())
+    {
+        recover();
+    }
+    else
+    {
+        if (existing)
+        {
+            logger.logToConsole("History file " + path + " has an invalid header, starting a new history");
+        }
+        initialize();
+    }
+}
+
+HistoryFile::~HistoryFile()
+{
+    if (base != nullptr)
+    {
+        msync(base, fileSize, MS_ASYNC);
+        munmap(base, fileSize);
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+}
+
+HistoryFile::SegmentHeader *HistoryFile::segment(size_t index) const
+{
+    return reinterpret_cast<SegmentHeader *>(base + roundToPage(sizeof(Header)) + index * segmentSize);
+}
+
+HistoryFile::Record *HistoryFile::record(size_t segmentIndex, size_t recordIndex) const
+{
+    return reinterpret_cast<Record *>(reinterpret_cast<char *>(segment(segmentIndex)) + sizeof(SegmentHeader)) + recordIndex;
+}
+
+size_t HistoryFile::recordsPerSegment() const
+{
+    return (segmentSize - sizeof(SegmentHeader)) / sizeof(Record);
+}
+
+uint32_t HistoryFile::headerChecksum() const
+{
+    return crc32(0, header(), offsetof(Header, checksum));
+}
+
+uint32_t HistoryFile::recordChecksum(const Record &record, uint64_t sequence) const
+{
+    return crc32(crc32(0, &sequence, sizeof(sequence)), &record, offsetof(Record, checksum));
+}
+
+bool HistoryFile::validHeader() const
+{
+    const Header &current = *header();
+    return std::memcmp(current.magic, HISTORY_MAGIC, sizeof(HISTORY_MAGIC)) == 0 && current.version == VERSION &&
+           current.headerSize == roundToPage(sizeof(Header)) && current.segmentSize == segmentSize &&
+           current.segmentCount == segmentCount && current.metricCount <= MAX_METRICS && validRollups() &&
+           current.checksum == headerChecksum();
+}
+
+bool HistoryFile::validRollups() const
+{
+    const Header &current = *header();
+    if (current.rollupCount != rollups.size())
+    {
+        return false;
+    }
+    for (size_t tier = 0; tier < rollups.size(); tier++)
+    {
+        if (current.rollupResolutionMS[tier] != rollups[tier].first || current.rollupBucketCount[tier] != rollups[tier].second)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool HistoryFile::validSegment(size_t index) const
+{
+    const SegmentHeader &current = *segment(index);
+    return current.magic == SEGMENT_MAGIC && current.checksum == crc32(0, &current, offsetof(SegmentHeader, checksum));
+}
+
+bool HistoryFile::validRecord(const Record &record, uint64_t sequence) const
+{
+    return record.checksum == recordChecksum(record, sequence) && record.metric < header()->metricCount;
+}
+
+void HistoryFile::initialize()
+{
+    std::memset(base, 0, fileSize);
+
+    Header &current = *header();
+    std::memcpy(current.magic, HISTORY_MAGIC, sizeof(HISTORY_MAGIC));
+    current.version = VERSION;
+    current.headerSize = static_cast<uint32_t>(roundToPage(sizeof(Header)));
+    current.segmentSize = segmentSize;
+    current.segmentCount = segmentCount;
+    current.metricCount = 0;
+    current.rollupCount = static_cast<uint32_t>(rollups.size());
+    for (size_t tier = 0; tier < rollups.size(); tier++)
+    {
+        current.rollupResolutionMS[tier] = rollups[tier].first;
+        current.rollupBucketCount[tier] = rollups[tier].second;
+    }
+    current.checksum = headerChecksum();
+
+    startSegment(0, 1);
+}
+
+/**
+ * @brief Restores the write position of a re-attached file.
+ *
+ * The header cursor is updated after every record, but after a crash (or when the kernel
+ * wrote back the pages in a different order) it can be off by a few records. Starting at
+ * the cursor, invalid records before it are dropped (the partial last record) and valid
+ * records after it are taken over. Only if the cursor points to a segment with a broken
+ * header are all segment headers scanned for the newest one.
+ */
+void HistoryFile::recover()
+{
+    uint64_t cursor = header()->cursor;
+    currentSegment = static_cast<size_t>(cursor >> 32);
+    currentRecord = static_cast<size_t>(cursor & 0xFFFFFFFFu);
+
+    if (currentSegment >= segmentCount || !validSegment(currentSegment) || currentRecord > recordsPerSegment())
+    {
+        bool found = false;
+        for (size_t index = 0; index < segmentCount; index++)
+        {
+            if (validSegment(index) && (!found || segment(index)->sequence > segment(currentSegment)->sequence))
+            {
+                currentSegment = index;
+                found = true;
+            }
+        }
+        if (!found)
+        {
+            logger.logToConsole("History file " + path + " has no valid segment, starting a new history");
+            initialize();
+            return;
+        }
+        currentRecord = 0;
+    }
+    currentSequence = segment(currentSegment)->sequence;
+
+    size_t truncated = 0;
+    while (currentRecord > 0 && !validRecord(*record(currentSegment, currentRecord - 1), currentSequence))
+    {
+        currentRecord--;
+        truncated++;
+    }
+    while (currentRecord < recordsPerSegment() && validRecord(*record(currentSegment, currentRecord), currentSequence))
+    {
+        currentRecord++;
+    }
+    storeCursor();
+
+    if (truncated > 0)
+    {
+        logger.logToConsole("History file " + path + ": dropped " + std::to_string(truncated) + " partial record(s)");
+    }
+}
+
+void HistoryFile::startSegment(size_t index, uint64_t sequence)
+{
+    SegmentHeader &current = *segment(index);
+    current.sequence = sequence;
+    current.magic = SEGMENT_MAGIC;
+    current.checksum = crc32(0, &current, offsetof(SegmentHeader, checksum));
+
+    currentSegment = index;
+    currentRecord = 0;
+    currentSequence = sequence;
+    storeCursor();
+}
+
+void HistoryFile::storeCursor()
+{
+    __atomic_store_n(&header()->cursor, (static_cast<uint64_t>(currentSegment) << 32) | currentRecord, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Looks up a metric in the name table, adding it if needed.
+ *
+ * Records store the table index instead of the name. Metrics keep their index across
+ * restarts, so records written by a previous run are mapped back to the same metric.
+ */
+int HistoryFile::metricIndex(const std::string &name)
+{
+    if (base == nullptr || name.size() >= MAX_NAME)
+    {
+        return -1;
+    }
+
+    Header &current = *header();
+    for (uint32_t index = 0; index < current.metricCount; index++)
+    {
+        if (name == current.metricNames[index])
+        {
+            return static_cast<int>(index);
+        }
+    }
+
+    if (current.metricCount >= MAX_METRICS)
+    {
+        logger.logToConsole("History file metric table is full, '" + name + "' is not persisted");
+        return -1;
+    }
+
+    std::memset(current.metricNames[current.metricCount], 0, MAX_NAME);
+    std::memcpy(current.metricNames[current.metricCount], name.c_str(), name.size());
+    current.metricCount++;
+    current.checksum = headerChecksum();
+    return static_cast<int>(current.metricCount) - 1;
+}
+
+std::string HistoryFile::metricName(int index) const
+{
+    if (base == nullptr || index < 0 || static_cast<uint32_t>(index) >= header()->metricCount)
+    {
+        return "";
+    }
+    return std::string(header()->metricNames[index]);
+}
+
+/**
+ * @brief Appends one record through the mapping.
+ *
+ * The record is written in place and its checksum last; the cursor in the header is
+ * advanced afterwards. A full segment moves the cursor to the next segment of the ring,
+ * which starts a new sequence and thereby invalidates the records of its previous lap at
+ * once. Nothing is flushed explicitly: the page cache keeps the data across a crash of the
+ * process, and the kernel writes it back on its own schedule.
+ */
+void HistoryFile::append(int metric, int64_t timeMS, double value)
+{
+    if (base == nullptr || metric < 0)
+    {
+        return;
+    }
+
+    if (currentRecord >= recordsPerSegment())
+    {
+        // let the kernel start writing back the completed segment
+        msync(segment(currentSegment), segmentSize, MS_ASYNC);
+        startSegment((currentSegment + 1) % segmentCount, currentSequence + 1);
+    }
+
+    Record &current = *record(currentSegment, currentRecord);
+    current.timeMS = timeMS;
+    current.value = value;
+    current.metric = static_cast<uint32_t>(metric);
+    current.checksum = recordChecksum(current, currentSequence);
+
+    currentRecord++;
+    storeCursor();
+}
+
+/**
+ * @brief Reads all valid records of the file.
+ *
+ * Segments are visited in sequence order (oldest first), and each segment up to its first
+ * invalid record, so the records come out in the order they were written.
+ */
+void HistoryFile::forEach(const std::function<void(int metric, int64_t timeMS, double value)> &callback) const
+{
+    if (base == nullptr)
+    {
+        return;
+    }
+
+    std::vector<std::pair<uint64_t, size_t>> segments;
+    for (size_t index = 0; index < segmentCount; index++)
+    {
+        if (validSegment(index))
+        {
+            segments.push_back(std::make_pair(segment(index)->sequence, index));
+        }
+    }
+    std::sort(segments.begin(), segments.end());
+
+    for (const auto &entry : segments)
+    {
+        size_t limit = entry.second == currentSegment ? currentRecord : recordsPerSegment();
+        for (size_t index = 0; index < limit; index++)
+        {
+            const Record &current = *record(entry.second, index);
+            if (!validRecord(current, entry.first))
+            {
+                break;
+            }
+            callback(static_cast<int>(current.metric), current.timeMS, current.value);
+        }
+    }
+}
+
+/**
+ * @brief Finds the mapped buckets of a rollup tier.
+ *
+ * The buckets of metric `metric` (its index in the name table) and tier `t` start at
+ * rollupOffset + metric * rollupMetricBytes + the buckets of the tiers before `t`. They
+ * are written in place by `RollupTier::add`; like the records, they reach the disk when
+ * the kernel writes the pages back.
+ *
+ * @return The buckets, nullptr if the file is not open, the metric has no rollup slot
+ *         (index MAX_ROLLUP_METRICS or above) or no tier of the file has this geometry.
+ */
+RollupBucket *HistoryFile::rollupBuckets(int metric, int64_t resolutionMS, size_t bucketCount) const
+{
+    if (base == nullptr || metric < 0 || static_cast<size_t>(metric) >= MAX_ROLLUP_METRICS)
+    {
+        return nullptr;
+    }
+
+    size_t offset = rollupOffset + static_cast<size_t>(metric) * rollupMetricBytes;
+    for (const auto &tier : rollups)
+    {
+        if (tier.first == resolutionMS && tier.second == bucketCount)
+        {
+            return reinterpret_cast<RollupBucket *>(base + offset);
+        }
+        offset += static_cast<size_t>(tier.second) * sizeof(RollupBucket);
+    }
+    return nullptr;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include "log/Log.hpp"
+#include "history/RollupTier.hpp"
+#include "history/RollupTierStructure.hpp"
+
+/**
+ * Memory-mapped, append-only history file made of fixed-size segments.
+ *
+ * The file starts with a header (magic, version, geometry, metric name table and their
+ * checksum, followed by the write cursor) and is followed by `segmentCount` segments used
+ * as a ring. Every segment starts with its own sequence number and holds fixed-size
+ * records, each protected by a CRC that also covers the segment sequence, so records
+ * left over from a previous lap of the ring never validate.
+ *
+ * The segments are followed by the rollup area: for each of the first MAX_ROLLUP_METRICS
+ * metrics of the name table, the bucket rings of the configured rollup tiers (geometry in
+ * the header). Rollup tiers live in this area (`RollupTier::attach`), so they are kept
+ * across restarts as they are, far beyond the raw records of the segment ring.
+ */
+class HistoryFile
+{
+public:
+    HistoryFile(const std::string &path, size_t segmentSize, size_t segmentCount,
+                const std::vector<RollupTierStructure> &rollups = std::vector<RollupTierStructure>());
+    ~HistoryFile();
+
+    HistoryFile(const HistoryFile &) = delete;
+    HistoryFile &operator=(const HistoryFile &) = delete;
+
+    bool isOpen() const { return base != nullptr; }
+
+    // Index of a metric in the name table, the name is added if it is new; -1 if the table is full
+    int metricIndex(const std::string &name);
+
+    // Name of a metric of the table
+    std::string metricName(int index) const;
+
+    // Appends a record through the mapping, called by the single writer
+    void append(int metric, int64_t timeMS, double value);
+
+    // Calls `callback` for every valid record, oldest segment first
+    void forEach(const std::function<void(int metric, int64_t timeMS, double value)> &callback) const;
+
+    // Mapped buckets of a metric's rollup tier with this geometry, nullptr if the file keeps none
+    RollupBucket *rollupBuckets(int metric, int64_t resolutionMS, size_t bucketCount) const;
+
+    static const uint32_t VERSION = 2;
+    static const size_t MAX_METRICS = 128;
+    static const size_t MAX_NAME = 48;
+    static const size_t MAX_ROLLUPS = 4;
+    static const size_t MAX_ROLLUP_METRICS = 32;
+
+private:
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint64_t segmentSize;
+        uint64_t segmentCount;
+        uint32_t metricCount;
+        char metricNames[MAX_METRICS][MAX_NAME];
+        uint32_t rollupCount;
+        int64_t rollupResolutionMS[MAX_ROLLUPS];
+        uint64_t rollupBucketCount[MAX_ROLLUPS];
+        uint32_t checksum; // covers everything above
+
+        // Write position: segment index in the high 32 bits, record index in the low 32 bits.
+        // Outside the checksum, it changes with every append.
+        uint64_t cursor;
+    };
+
+    struct SegmentHeader
+    {
+        uint64_t sequence;
+        uint32_t magic;
+        uint32_t checksum;
+    };
+
+    struct Record
+    {
+        int64_t timeMS;
+        double value;
+        uint32_t metric;
+        uint32_t checksum; // covers the fields above and the segment sequence
+    };
+
+    Header *header() const { return reinterpret_cast<Header *>(base); }
+    SegmentHeader *segment(size_t index) const;
+    Record *record(size_t segmentIndex, size_t recordIndex) const;
+    size_t recordsPerSegment() const;
+
+    bool validHeader() const;
+    bool validRollups() const;
+    bool validSegment(size_t index) const;
+    bool validRecord(const Record &record, uint64_t sequence) const;
+    uint32_t headerChecksum() const;
+    uint32_t recordChecksum(const Record &record, uint64_t sequence) const;
+
+    void initialize();
+    void recover();
+    void startSegment(size_t index, uint64_t sequence);
+    void storeCursor();
+
+    std::string path;
+    size_t segmentSize;
+    size_t segmentCount;
+    std::vector<std::pair<int64_t, uint64_t>> rollups; // resolution and bucket count per tier
+    size_t rollupOffset;      // start of the rollup area
+    size_t rollupMetricBytes; // rollup buckets of one metric
+    size_t fileSize;
+    int fd;
+    char *base;
+
+    // Write position
+    size_t currentSegment;
+    size_t currentRecord;
+    uint64_t currentSequence;
+
+    Log logger;
+};
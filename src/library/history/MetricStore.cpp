@@ -0,0 +1,456 @@
+#include "MetricStore.hpp"
+
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+
+// Samples per Gorilla chunk, about 8.5 minutes at a 500 ms check duration
+static const size_t SAMPLES_PER_CHUNK = 1024;
+
+/**
+ * @brief Creates an empty store.
+ *
+ * @param capacity Samples retained per metric (`history_capacity`).
+ * @param memoryBudgetBytes Upper bound for the memory of all rings (`history_memory_budget_mb`).
+ * @param retentionHours Hours of compressed history kept per metric (`history_retention_hours`).
+ * @param precision Decimals kept in the compressed history (`history_precision`), negative
+ *                  to keep full precision.
+ * @param rollups Downsampling tiers kept per metric (`history_rollups`), e.g. 1 minute for
+ *                7 days and 1 hour for 90 days.
+ * @param sketchResolutionSec Window of one quantile sketch (`history_sketch_resolution_sec`).
+ * @param sketchRetentionHours Hours of quantile sketches kept per metric
+ *                             (`history_sketch_retention_hours`), 0 disables them.
+ */
+MetricStore::MetricStore(size_t capacity, size_t memoryBudgetBytes, int retentionHours, int precision,
+                         const std::vector<RollupTierStructure> &rollups, int sketchResolutionSec, int sketchRetentionHours)
+    : capacity(capacity), memoryBudget(memoryBudgetBytes), usedBytes(0),
+      retentionMS(static_cast<int64_t>(retentionHours) * 3600 * 1000),
+      precisionScale(precision >= 0 ? std::pow(10.0, precision) : 0.0), rollups(rollups),
+      sketchResolutionMS(static_cast<int64_t>(sketchResolutionSec) * 1000),
+      sketchRetentionMS(static_cast<int64_t>(sketchRetentionHours) * 3600 * 1000), file(nullptr)
+{
+    // finest tier first, so queries can pick the first tier that covers a window
+    std::sort(this->rollups.begin(), this->rollups.end(), [](const RollupTierStructure &a, const RollupTierStructure &b)
+              { return a.resolutionSec < b.resolutionSec; });
+}
+
+/**
+ * @brief Registers a metric and allocates its ring, rollup tiers and sketch windows.
+ *
+ * All rings and tiers are allocated here, before the scheduler starts, so recording never
+ * allocates (apart from the compressed history, which grows by one chunk at a time up to its
+ * retention). Tiers and sketches are allocated first and count against the memory budget. A ring gets
+ * `capacity` samples as long as the budget allows it; once the budget runs low, later
+ * metrics get a smaller ring, and when it is exhausted the metric is not recorded at all. Readers on other threads access the registry without locking, which
+ * is why it must not change once sampling has started.
+ *
+ * @param name Metric name, e.g. "cpu" or "psi.io".
+ * @return The id of the metric, or -1 if no memory is left.
+ */
+int MetricStore::registerMetric(const std::string &name)
+{
+    int existing = find(name);
+    if (existing >= 0)
+    {
+        return existing;
+    }
+
+    std::vector<std::unique_ptr<RollupTier>> metricTiers;
+    size_t tierBytes = 0;
+    for (const RollupTierStructure &rollup : rollups)
+    {
+        metricTiers.emplace_back(new RollupTier(static_cast<int64_t>(rollup.resolutionSec) * 1000,
+                                                static_cast<int64_t>(rollup.retentionHours) * 3600 * 1000));
+        tierBytes += metricTiers.back()->getSizeBytes();
+    }
+
+    std::unique_ptr<SketchTier> sketch;
+    if (sketchResolutionMS > 0 && sketchRetentionMS > 0)
+    {
+        sketch.reset(new SketchTier(sketchResolutionMS, sketchRetentionMS));
+        tierBytes += sketch->getSizeBytes();
+    }
+
+    // approximate footprint of one slot (timestamp + value) and of the ring itself
+    size_t slotBytes = sizeof(int64_t) + sizeof(double);
+    size_t remaining = memoryBudget > usedBytes + tierBytes + sizeof(SampleRing) ? memoryBudget - usedBytes - tierBytes - sizeof(SampleRing) : 0;
+    size_t ringCapacity = std::min(capacity, remaining / slotBytes);
+    if (ringCapacity < 2)
+    {
+        logger.logToConsole("History memory budget exhausted, metric '" + name + "' is not recorded");
+        return -1;
+    }
+    if (ringCapacity < capacity)
+    {
+        logger.logToConsole("History memory budget reached, metric '" + name + "' keeps " + std::to_string(ringCapacity) + " samples");
+    }
+
+    rings.emplace_back(new SampleRing(ringCapacity));
+    series.emplace_back(new CompressedSeries(SAMPLES_PER_CHUNK, retentionMS));
+    tiers.push_back(std::move(metricTiers));
+    sketches.push_back(std::move(sketch));
+    names.push_back(name);
+    usedBytes += tierBytes + sizeof(SampleRing) + ringCapacity * slotBytes;
+    return static_cast<int>(rings.size()) - 1;
+}
+
+/**
+ * @brief Appends a sample to the ring, the compressed history, the rollup tiers and the
+ * quantile sketches of a metric, and to the history file if one is attached.
+ *
+ * The ring keeps the exact value for recent windows. The compressed history keeps the
+ * value rounded to `history_precision` decimals: the XOR encoding stores an unchanged
+ * value in a single bit, and full-precision percentages practically never repeat.
+ */
+void MetricStore::record(int id, int64_t timeMS, double value)
+{
+    if (id < 0 || id >= static_cast<int>(rings.size()))
+    {
+        return;
+    }
+
+    store(id, timeMS, value);
+    if (file != nullptr)
+    {
+        file->append(fileIds[id], timeMS, value);
+    }
+}
+
+void MetricStore::store(int id, int64_t timeMS, double value, bool replaying)
+{
+    rings[id]->push(timeMS, value);
+    series[id]->append(timeMS, precisionScale > 0 ? std::round(value * precisionScale) / precisionScale : value);
+    for (const auto &tier : tiers[id])
+    {
+        // a tier kept in the history file already holds the replayed samples
+        if (!replaying || !tier->isAttached())
+        {
+            tier->add(timeMS, value);
+        }
+    }
+    if (sketches[id])
+    {
+        sketches[id]->add(timeMS, value);
+    }
+}
+
+/**
+ * @brief Restores the histories from a history file and persists all following samples.
+ *
+ * The rollup tiers move into the rollup area of the file (`HistoryFile::rollupBuckets`),
+ * which still holds the buckets of the previous run, so the 1-minute and 1-hour history is
+ * back at once, however old, without replaying anything. The in-memory histories (ring,
+ * compressed history, sketches) are rebuilt by replaying every record of the file whose
+ * metric is registered, oldest first; rollup tiers without a place in the file (metrics
+ * beyond `HistoryFile::MAX_ROLLUP_METRICS`) are replayed too. Metrics of the file that are
+ * no longer registered are skipped.
+ *
+ * @param historyFile Open history file; must outlive the store.
+ */
+void MetricStore::attachFile(HistoryFile &historyFile)
+{
+    if (!historyFile.isOpen())
+    {
+        return;
+    }
+
+    fileIds.assign(names.size(), -1);
+    size_t attached = 0;
+    for (size_t id = 0; id < names.size(); id++)
+    {
+        fileIds[id] = historyFile.metricIndex(names[id]);
+        for (const auto &tier : tiers[id])
+        {
+            RollupBucket *storage = historyFile.rollupBuckets(fileIds[id], tier->getResolutionMS(), tier->getBucketCount());
+            if (storage != nullptr)
+            {
+                usedBytes -= tier->getSizeBytes();
+                tier->attach(storage);
+                attached++;
+            }
+        }
+    }
+
+    // file index -> store id, resolved once for the replay
+    std::vector<int> storeIds(HistoryFile::MAX_METRICS, -1);
+    for (size_t index = 0; index < HistoryFile::MAX_METRICS; index++)
+    {
+        storeIds[index] = find(historyFile.metricName(static_cast<int>(index)));
+    }
+
+    size_t replayed = 0;
+    historyFile.forEach([this, &storeIds, &replayed](int metric, int64_t timeMS, double value)
+                        {
+                            if (storeIds[metric] >= 0)
+                            {
+                                store(storeIds[metric], timeMS, value, true);
+                                replayed++;
+                            } });
+    logger.logToConsole("History restored: " + std::to_string(attached) + " rollup tiers, " + std::to_string(replayed) + " samples");
+
+    file = &historyFile;
+}
+
+/**
+ * @brief Reads a time window from the finest history that covers it.
+ *
+ * The ring is used while its oldest retained sample is not newer than `sinceMS`; each
+ * sample is returned as a bucket of one. Otherwise the finest rollup tier whose retention
+ * reaches back to `sinceMS` is used (or the coarsest tier if none does), so a query over
+ * a week reads about ten thousand 1-minute buckets instead of a million raw samples.
+ *
+ * @return Width of the returned buckets in milliseconds, 0 for raw samples, -1 for an unknown id.
+ */
+int64_t MetricStore::query(int id, int64_t sinceMS, int64_t untilMS, std::vector<RollupBucket> &out) const
+{
+    if (id < 0 || id >= static_cast<int>(rings.size()))
+    {
+        return -1;
+    }
+
+    const SampleRing &ring = *rings[id];
+    Sample oldest;
+    if ((ring.oldest(oldest) && oldest.timeMS <= sinceMS) || tiers[id].empty())
+    {
+        std::vector<Sample> samples;
+        ring.readSince(sinceMS, samples);
+        for (const Sample &sample : samples)
+        {
+            if (sample.timeMS > untilMS)
+            {
+                break;
+            }
+            float value = static_cast<float>(sample.value);
+            out.push_back(RollupBucket{sample.timeMS, sample.value, value, value, value, 1});
+        }
+        return 0;
+    }
+
+    int64_t nowMS = MetricStore::nowMS();
+    for (const auto &tier : tiers[id])
+    {
+        // one bucket of slack, so "the last 7 days" still fits a 7-day tier
+        if (nowMS - tier->getRetentionMS() - tier->getResolutionMS() <= sinceMS || tier == tiers[id].back())
+        {
+            tier->read(sinceMS, untilMS, out);
+            return tier->getResolutionMS();
+        }
+    }
+    return -1;
+}
+
+// Folds a bucket into the step bucket it falls into; source buckets arrive oldest first
+static void addToStep(std::vector<RollupBucket> &out, size_t first, int64_t stepMS, const RollupBucket &bucket)
+{
+    int64_t startMS = bucket.startMS - bucket.startMS % stepMS;
+    if (out.size() == first || out.back().startMS != startMS)
+    {
+        out.push_back(RollupBucket{startMS, 0.0, bucket.min, bucket.max, bucket.last, 0});
+    }
+
+    RollupBucket &step = out.back();
+    step.sum += bucket.sum;
+    step.min = std::min(step.min, bucket.min);
+    step.max = std::max(step.max, bucket.max);
+    step.last = bucket.last;
+    step.count += bucket.count;
+}
+
+/**
+ * @brief Aggregates a time window into steps of a fixed width.
+ *
+ * The source is the coarsest rollup tier whose bucket width is not larger than the step and
+ * whose retention still reaches back to `sinceMS`, so 30 days in 6-hour steps read 720
+ * hourly buckets and never decode any compressed chunk. Steps finer than every tier are
+ * answered from raw samples: the ring while it reaches back far enough, otherwise the
+ * compressed history, of which only the chunks overlapping the window are decoded. Windows
+ * older than the compressed history fall back to the finest tier that covers them.
+ *
+ * @param stepMS Width of one returned bucket; buckets start at multiples of it.
+ * @param out Receives one bucket per step that has samples, oldest first.
+ * @return Bucket width of the source in milliseconds, 0 for raw samples, -1 for an unknown id.
+ */
+int64_t MetricStore::aggregate(int id, int64_t sinceMS, int64_t untilMS, int64_t stepMS, std::vector<RollupBucket> &out) const
+{
+    if (id < 0 || id >= static_cast<int>(rings.size()))
+    {
+        return -1;
+    }
+    stepMS = std::max<int64_t>(stepMS, 1);
+
+    int64_t nowMS = MetricStore::nowMS();
+    const RollupTier *source = nullptr;
+    for (auto tier = tiers[id].rbegin(); tier != tiers[id].rend(); ++tier)
+    {
+        // one bucket of slack, like query()
+        if ((*tier)->getResolutionMS() <= stepMS && nowMS - (*tier)->getRetentionMS() - (*tier)->getResolutionMS() <= sinceMS)
+        {
+            source = tier->get();
+            break;
+        }
+    }
+
+    if (source == nullptr && (sinceMS < nowMS - retentionMS || retentionMS <= 0))
+    {
+        for (const auto &tier : tiers[id])
+        {
+            if (nowMS - tier->getRetentionMS() - tier->getResolutionMS() <= sinceMS || tier == tiers[id].back())
+            {
+                source = tier.get();
+                break;
+            }
+        }
+    }
+
+    size_t first = out.size();
+    if (source != nullptr)
+    {
+        std::vector<RollupBucket> buckets;
+        source->read(sinceMS, untilMS, buckets);
+        for (const RollupBucket &bucket : buckets)
+        {
+            addToStep(out, first, stepMS, bucket);
+        }
+        return source->getResolutionMS();
+    }
+
+    std::vector<Sample> samples;
+    Sample oldest;
+    if (rings[id]->oldest(oldest) && oldest.timeMS <= sinceMS)
+    {
+        rings[id]->readSince(sinceMS, samples);
+    }
+    else
+    {
+        series[id]->read(sinceMS, untilMS, samples);
+    }
+    for (const Sample &sample : samples)
+    {
+        if (sample.timeMS > untilMS)
+        {
+            break;
+        }
+        float value = static_cast<float>(sample.value);
+        addToStep(out, first, stepMS, RollupBucket{sample.timeMS, sample.value, value, value, value, 1});
+    }
+    return 0;
+}
+
+/**
+ * @brief Streams the step buckets of a long window block by block.
+ *
+ * The window is cut into sub-windows of `blockSteps` steps, aligned to the step, and each
+ * is aggregated on its own, so only one block of buckets is held at a time. Every block
+ * picks its source like `aggregate`, so the part of the window that only a coarser tier
+ * still covers comes from that tier; a block is cut where the tiers that fit the step
+ * begin to cover the window, so no finer history is lost to a coarse block. A coarse
+ * bucket that starts before its block was already passed with the previous block and is
+ * skipped.
+ *
+ * @param callback Receives the non-empty blocks, oldest first; the vector is reused.
+ */
+void MetricStore::forEachBlock(int id, int64_t sinceMS, int64_t untilMS, int64_t stepMS, size_t blockSteps,
+                               const std::function<void(const std::vector<RollupBucket> &)> &callback) const
+{
+    stepMS = std::max<int64_t>(stepMS, 1);
+    int64_t blockMS = stepMS * static_cast<int64_t>(std::max<size_t>(blockSteps, 1));
+
+    // earliest time covered by a tier that fits the step, like the tier choice of aggregate()
+    int64_t fineStartMS = INT64_MAX;
+    if (id >= 0 && id < static_cast<int>(tiers.size()))
+    {
+        int64_t nowMS = MetricStore::nowMS();
+        for (const auto &tier : tiers[id])
+        {
+            if (tier->getResolutionMS() <= stepMS)
+            {
+                int64_t startMS = nowMS - tier->getRetentionMS() - tier->getResolutionMS();
+                fineStartMS = std::min(fineStartMS, startMS + stepMS - 1 - (startMS + stepMS - 1) % stepMS);
+            }
+        }
+    }
+
+    std::vector<RollupBucket> block;
+    int64_t lastEmittedMS = INT64_MIN;
+    for (int64_t blockStartMS = sinceMS - sinceMS % stepMS, blockEndMS; blockStartMS <= untilMS; blockStartMS = blockEndMS + 1)
+    {
+        block.clear();
+        blockEndMS = std::min(untilMS, blockStartMS + blockMS - 1);
+        if (blockStartMS < fineStartMS && fineStartMS <= blockEndMS)
+        {
+            blockEndMS = fineStartMS - 1;
+        }
+        if (aggregate(id, std::max(blockStartMS, sinceMS), blockEndMS, stepMS, block) < 0)
+        {
+            return;
+        }
+
+        block.erase(std::remove_if(block.begin(), block.end(), [lastEmittedMS](const RollupBucket &bucket)
+                                   { return bucket.startMS <= lastEmittedMS; }),
+                    block.end());
+        if (!block.empty())
+        {
+            lastEmittedMS = block.back().startMS;
+            callback(block);
+        }
+    }
+}
+
+/**
+ * @brief Answers percentiles of a time window from constant-size state.
+ *
+ * The sketch windows overlapping the time window are merged, so p50/p90/p99/max over the
+ * last 5 minutes or the last 24 hours cost the same regardless of the check duration.
+ * The window is rounded outwards to whole sketch windows. The result can be merged further,
+ * e.g. with the sketches of other metrics or, through `QuantileSketch::serialize`, of other nodes.
+ *
+ * @param out Sketch the windows are merged into.
+ * @return False for an unknown id or when sketches are disabled.
+ */
+bool MetricStore::quantiles(int id, int64_t sinceMS, int64_t untilMS, QuantileSketch &out) const
+{
+    if (id < 0 || id >= static_cast<int>(sketches.size()) || !sketches[id])
+    {
+        return false;
+    }
+
+    sketches[id]->merge(sinceMS, untilMS, out);
+    return true;
+}
+
+int64_t MetricStore::getRetentionMS() const
+{
+    int64_t longest = retentionMS;
+    for (const RollupTierStructure &rollup : rollups)
+    {
+        longest = std::max(longest, static_cast<int64_t>(rollup.retentionHours) * 3600 * 1000);
+    }
+    return longest;
+}
+
+int MetricStore::find(const std::string &name) const
+{
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        if (names[i] == name)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+const SampleRing *MetricStore::getRing(int id) const
+{
+    return (id >= 0 && id < static_cast<int>(rings.size())) ? rings[id].get() : nullptr;
+}
+
+const CompressedSeries *MetricStore::getSeries(int id) const
+{
+    return (id >= 0 && id < static_cast<int>(series.size())) ? series[id].get() : nullptr;
+}
+
+int64_t MetricStore::nowMS()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "log/Log.hpp"
+#include "history/SampleRing.hpp"
+#include "history/CompressedSeries.hpp"
+#include "history/RollupTier.hpp"
+#include "history/RollupTierStructure.hpp"
+#include "history/SketchTier.hpp"
+#include "history/QuantileSketch.hpp"
+#include "history/HistoryFile.hpp"
+
+class MetricStore
+{
+public:
+    MetricStore(size_t capacity, size_t memoryBudgetBytes, int retentionHours = 24, int precision = 2,
+                const std::vector<RollupTierStructure> &rollups = std::vector<RollupTierStructure>(),
+                int sketchResolutionSec = 60, int sketchRetentionHours = 24);
+
+    // Registers a metric and allocates its ring and tiers, must be called before sampling starts.
+    // Returns -1 if the memory budget is exhausted.
+    int registerMetric(const std::string &name);
+
+    // Appends a sample taken now, called by the collector that owns the metric
+    void record(int id, double value) { record(id, nowMS(), value); }
+    void record(int id, int64_t timeMS, double value);
+
+    // Moves the rollup tiers into a history file, replays its records into the other
+    // histories and persists every following sample into it; must be called after all
+    // metrics are registered and before sampling starts
+    void attachFile(HistoryFile &file);
+
+    // Id of a registered metric, or -1
+    int find(const std::string &name) const;
+
+    // Ring of a metric, nullptr for an unknown id
+    const SampleRing *getRing(int id) const;
+
+    // Compressed long-term history of a metric, nullptr for an unknown id
+    const CompressedSeries *getSeries(int id) const;
+
+    // Rollup tiers of a metric, finest first
+    const std::vector<std::unique_ptr<RollupTier>> &getTiers(int id) const { return tiers[id]; }
+
+    // Buckets of [sinceMS, untilMS] from the finest history that still covers sinceMS:
+    // raw samples (as buckets of one sample) while the ring reaches back far enough, then the
+    // rollup tiers. Returns the bucket width in milliseconds, 0 for raw samples.
+    int64_t query(int id, int64_t sinceMS, int64_t untilMS, std::vector<RollupBucket> &out) const;
+
+    // Min/avg/max per step of [sinceMS, untilMS] from the coarsest history whose resolution
+    // still fits the step. Returns the resolution of the source, 0 for raw samples, -1 for an unknown id.
+    int64_t aggregate(int id, int64_t sinceMS, int64_t untilMS, int64_t stepMS, std::vector<RollupBucket> &out) const;
+
+    // Streams aggregate() over [sinceMS, untilMS] in blocks of at most `blockSteps` buckets, so
+    // long windows are exported in bounded memory
+    void forEachBlock(int id, int64_t sinceMS, int64_t untilMS, int64_t stepMS, size_t blockSteps,
+                      const std::function<void(const std::vector<RollupBucket> &)> &callback) const;
+
+    // Quantile sketch of [sinceMS, untilMS], merged from the sketch windows of the metric.
+    // Returns false for an unknown id or when sketches are disabled.
+    bool quantiles(int id, int64_t sinceMS, int64_t untilMS, QuantileSketch &out) const;
+
+    const std::vector<std::string> &getNames() const { return names; }
+
+    // Longest history kept by the compressed series or any rollup tier, in milliseconds
+    int64_t getRetentionMS() const;
+
+    // Current wall clock time in milliseconds since the epoch
+    static int64_t nowMS();
+
+private:
+    // Adds a sample to the histories only, not to the history file; a replayed sample
+    // skips the rollup tiers kept in the file
+    void store(int id, int64_t timeMS, double value, bool replaying = false);
+
+    size_t capacity;
+    size_t memoryBudget;
+    size_t usedBytes;
+    int64_t retentionMS;
+    double precisionScale;
+    std::vector<std::string> names;
+    std::vector<std::unique_ptr<SampleRing>> rings;
+    std::vector<std::unique_ptr<CompressedSeries>> series;
+    std::vector<RollupTierStructure> rollups;
+    std::vector<std::vector<std::unique_ptr<RollupTier>>> tiers;
+    int64_t sketchResolutionMS;
+    int64_t sketchRetentionMS;
+    std::vector<std::unique_ptr<SketchTier>> sketches;
+    HistoryFile *file;
+    std::vector<int> fileIds;
+    Log logger;
+};
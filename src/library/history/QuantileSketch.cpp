@@ -0,0 +1,304 @@
+#include "QuantileSketch.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+constexpr double QuantileSketch::GAMMA;
+constexpr double QuantileSketch::MIN_VALUE;
+const uint8_t QuantileSketch::FORMAT_VERSION;
+
+QuantileSketch::QuantileSketch() : zeroCount(0), count(0), min(0.0), max(0.0)
+{
+    std::memset(counts, 0, sizeof(counts));
+}
+
+/**
+ * @brief Maps a value to its bucket.
+ *
+ * Bucket i > 0 holds the values in (MIN_VALUE * GAMMA^(i-1), MIN_VALUE * GAMMA^i]; bucket 0
+ * holds (0, MIN_VALUE] and the last bucket everything above its lower bound.
+ */
+int QuantileSketch::bucketIndex(double value)
+{
+    if (!(value > 0.0))
+    {
+        return -1;
+    }
+
+    static const double logGamma = std::log(GAMMA);
+    double index = std::ceil(std::log(value / MIN_VALUE) / logGamma);
+    if (index <= 0.0)
+    {
+        return 0;
+    }
+    return index >= BUCKETS - 1 ? BUCKETS - 1 : static_cast<int>(index);
+}
+
+// Value reported for a bucket: the point with the same relative error to both bounds
+double QuantileSketch::bucketValue(int index)
+{
+    if (index < 0)
+    {
+        return 0.0;
+    }
+    if (index == 0)
+    {
+        return MIN_VALUE;
+    }
+    return MIN_VALUE * 2.0 * std::pow(GAMMA, index) / (GAMMA + 1.0);
+}
+
+void QuantileSketch::updateRange(double minValue, double maxValue)
+{
+    if (count == 0)
+    {
+        min = minValue;
+        max = maxValue;
+        return;
+    }
+    min = std::min(min, minValue);
+    max = std::max(max, maxValue);
+}
+
+void QuantileSketch::add(double value)
+{
+    int index = bucketIndex(value);
+    if (index < 0)
+    {
+        zeroCount++;
+    }
+    else
+    {
+        counts[index]++;
+    }
+    updateRange(value, value);
+    count++;
+}
+
+void QuantileSketch::addBucket(int index, uint64_t samples, double minValue, double maxValue)
+{
+    if (samples == 0)
+    {
+        return;
+    }
+
+    if (index < 0)
+    {
+        zeroCount += samples;
+    }
+    else if (index < BUCKETS)
+    {
+        counts[index] += samples;
+    }
+    updateRange(minValue, maxValue);
+    count += samples;
+}
+
+/**
+ * @brief Adds the counts of another sketch.
+ *
+ * Both sketches use the same fixed buckets, so the merged sketch is exactly the sketch of
+ * the union of both inputs and keeps the same error guarantee.
+ */
+void QuantileSketch::merge(const QuantileSketch &other)
+{
+    if (other.count == 0)
+    {
+        return;
+    }
+
+    zeroCount += other.zeroCount;
+    for (int index = 0; index < BUCKETS; index++)
+    {
+        counts[index] += other.counts[index];
+    }
+    updateRange(other.min, other.max);
+    count += other.count;
+}
+
+/**
+ * @brief Returns the value at a quantile.
+ *
+ * Walks the buckets up to the requested rank and reports the bucket's representative
+ * value, clamped to the exact minimum and maximum, so quantile(0) and quantile(1) are exact.
+ */
+double QuantileSketch::quantile(double q) const
+{
+    if (count == 0)
+    {
+        return 0.0;
+    }
+    if (q <= 0.0)
+    {
+        return min;
+    }
+    if (q >= 1.0)
+    {
+        return max;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count - 1));
+    uint64_t seen = zeroCount;
+    double value = max;
+    if (rank < seen)
+    {
+        value = 0.0;
+    }
+    else
+    {
+        for (int index = 0; index < BUCKETS; index++)
+        {
+            seen += counts[index];
+            if (rank < seen)
+            {
+                value = bucketValue(index);
+                break;
+            }
+        }
+    }
+
+    return std::min(std::max(value, min), max);
+}
+
+static void writeVarint(std::string &out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+static bool readVarint(const std::string &data, size_t &position, uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && position < data.size(); shift += 7)
+    {
+        uint8_t byte = static_cast<uint8_t>(data[position++]);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Doubles are written as their IEEE 754 bits in little endian, like the columnar export
+static void writeDouble(std::string &out, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        out.push_back(static_cast<char>((bits >> shift) & 0xff));
+    }
+}
+
+static bool readDouble(const std::string &data, size_t &position, double &value)
+{
+    if (data.size() - position < sizeof(uint64_t))
+    {
+        return false;
+    }
+    uint64_t bits = 0;
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        bits |= static_cast<uint64_t>(static_cast<uint8_t>(data[position++])) << shift;
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+/**
+ * @brief Serializes the sketch.
+ *
+ * Layout: FORMAT_VERSION byte; the bucket layout (BUCKETS as a varint, GAMMA and MIN_VALUE
+ * as doubles) so a node only merges sketches with the same buckets; min and max; then
+ * varints for the zero count, the number of non-empty buckets and (index, count) per
+ * non-empty bucket. A sketch of one window typically fits in a few dozen bytes.
+ */
+std::string QuantileSketch::serialize() const
+{
+    std::string out;
+    out.push_back(static_cast<char>(FORMAT_VERSION));
+    writeVarint(out, BUCKETS);
+    writeDouble(out, GAMMA);
+    writeDouble(out, MIN_VALUE);
+    writeDouble(out, min);
+    writeDouble(out, max);
+    writeVarint(out, zeroCount);
+
+    uint64_t used = 0;
+    for (int index = 0; index < BUCKETS; index++)
+    {
+        used += counts[index] > 0 ? 1 : 0;
+    }
+    writeVarint(out, used);
+    for (int index = 0; index < BUCKETS; index++)
+    {
+        if (counts[index] > 0)
+        {
+            writeVarint(out, static_cast<uint64_t>(index));
+            writeVarint(out, counts[index]);
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Reads a sketch written by `serialize`.
+ *
+ * Rejects other versions and other bucket layouts, since their counts cannot be added to
+ * these buckets, as well as truncated data or trailing bytes.
+ */
+bool QuantileSketch::deserialize(const std::string &data)
+{
+    QuantileSketch result;
+    size_t position = 1;
+    uint64_t buckets, used;
+    double gamma, minValue;
+    if (data.empty() || static_cast<uint8_t>(data[0]) != FORMAT_VERSION ||
+        !readVarint(data, position, buckets) || !readDouble(data, position, gamma) || !readDouble(data, position, minValue) ||
+        buckets != BUCKETS || gamma != GAMMA || minValue != MIN_VALUE)
+    {
+        return false;
+    }
+    if (!readDouble(data, position, result.min) || !readDouble(data, position, result.max) ||
+        !readVarint(data, position, result.zeroCount) || !readVarint(data, position, used))
+    {
+        return false;
+    }
+
+    result.count = result.zeroCount;
+    for (uint64_t i = 0; i < used; i++)
+    {
+        uint64_t index, samples;
+        if (!readVarint(data, position, index) || !readVarint(data, position, samples) || index >= BUCKETS)
+        {
+            return false;
+        }
+        result.counts[index] += samples;
+        result.count += samples;
+    }
+    if (position != data.size())
+    {
+        return false;
+    }
+
+    *this = result;
+    return true;
+}
+
+bool QuantileSketch::mergeSerialized(const std::string &data)
+{
+    QuantileSketch other;
+    if (!other.deserialize(data))
+    {
+        return false;
+    }
+    merge(other);
+    return true;
+}
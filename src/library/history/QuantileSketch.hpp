@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Mergeable quantile sketch with relative error guarantees (DDSketch, Masson et al., VLDB 2019).
+ *
+ * Positive values are counted in logarithmic buckets of ratio GAMMA, so any quantile is
+ * answered within about 3% of the true value. The bucket layout is fixed, which makes
+ * sketches of different windows, or of different nodes (see `serialize`), mergeable by
+ * adding their counts.
+ * Values up to MIN_VALUE share the first bucket and values of 0 or less are counted apart.
+ *
+ * The layout (BUCKETS buckets of ratio GAMMA above MIN_VALUE) tops out near 108, so it only
+ * fits percentages: larger values are clamped into the last bucket. `MetricStore` keeps a
+ * sketch for every registered metric, which is right as long as all of them (cpu, memory,
+ * swap, psi) are percentages; a metric in other units needs a different layout.
+ */
+class QuantileSketch
+{
+public:
+    static const int BUCKETS = 120;
+    static constexpr double GAMMA = 1.06;
+    static constexpr double MIN_VALUE = 0.1;
+    static const uint8_t FORMAT_VERSION = 1;
+
+    QuantileSketch();
+
+    void add(double value);
+    void merge(const QuantileSketch &other);
+
+    // Value at quantile q in [0, 1] (0.99 for p99), 0 for an empty sketch
+    double quantile(double q) const;
+
+    uint64_t getCount() const { return count; }
+    double getMin() const { return min; }
+    double getMax() const { return max; }
+
+    // Bucket of a value, -1 for the zero bucket
+    static int bucketIndex(double value);
+
+    // Adds `samples` values of a bucket with a known range, used to merge stored windows
+    void addBucket(int index, uint64_t samples, double minValue, double maxValue);
+
+    // Versioned binary form for exchanging sketches between the nodes of `node_list`
+    std::string serialize() const;
+    // Replaces the sketch, false (sketch unchanged) for another version or bucket layout
+    bool deserialize(const std::string &data);
+    // Merges a serialized sketch, false (sketch unchanged) if it cannot be read
+    bool mergeSerialized(const std::string &data);
+
+private:
+    static double bucketValue(int index);
+    void updateRange(double minValue, double maxValue);
+
+    uint64_t zeroCount;
+    uint64_t counts[BUCKETS];
+    uint64_t count;
+    double min;
+    double max;
+};
@@ -0,0 +1,97 @@
+#include "RollupTier.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief Allocates all buckets of the tier.
+ *
+ * @param resolutionMS Width of one bucket in milliseconds.
+ * @param retentionMS Time covered by the tier; the number of buckets is retention / resolution.
+ */
+RollupTier::RollupTier(int64_t resolutionMS, int64_t retentionMS)
+    : resolutionMS(std::max<int64_t>(resolutionMS, 1)),
+      bucketCount(static_cast<size_t>(std::max<int64_t>(retentionMS / std::max<int64_t>(resolutionMS, 1), 1))),
+      owned(bucketCount)
+{
+    for (RollupBucket &bucket : owned)
+    {
+        bucket.startMS = -1;
+        bucket.count = 0;
+    }
+    buckets = owned.data();
+}
+
+/**
+ * @brief Moves the tier into buckets mapped from a history file.
+ *
+ * The mapped buckets are taken over as they are, so the tier continues where the previous
+ * run stopped without replaying any sample; a zeroed (new) area reads as empty, since only
+ * buckets with samples are returned. The allocated ring is freed.
+ *
+ * @param storage `getBucketCount()` buckets, valid for the lifetime of the tier.
+ */
+void RollupTier::attach(RollupBucket *storage)
+{
+    std::lock_guard<std::mutex> lock(bucketsMutex);
+    buckets = storage;
+    std::vector<RollupBucket>().swap(owned);
+}
+
+/**
+ * @brief Adds a sample to the bucket its timestamp falls into.
+ *
+ * A slot whose stored start differs from the sample's bucket start holds a bucket that
+ * is one retention period older (or was never used); it is reset before the sample is
+ * added. Aggregates are therefore maintained incrementally as samples arrive, and a query
+ * never has to look at raw samples.
+ */
+void RollupTier::add(int64_t timeMS, double value)
+{
+    int64_t startMS = timeMS - timeMS % resolutionMS;
+    RollupBucket &bucket = buckets[static_cast<size_t>(startMS / resolutionMS) % bucketCount];
+
+    std::lock_guard<std::mutex> lock(bucketsMutex);
+    if (bucket.startMS != startMS)
+    {
+        bucket.startMS = startMS;
+        bucket.sum = 0.0;
+        bucket.min = static_cast<float>(value);
+        bucket.max = static_cast<float>(value);
+        bucket.count = 0;
+    }
+
+    bucket.sum += value;
+    bucket.min = std::min(bucket.min, static_cast<float>(value));
+    bucket.max = std::max(bucket.max, static_cast<float>(value));
+    bucket.last = static_cast<float>(value);
+    bucket.count++;
+}
+
+/**
+ * @brief Copies the buckets of a time window.
+ *
+ * Walks the bucket starts of the window and keeps the slots that still hold that
+ * bucket, so the cost is O(buckets in the window), independent of the number of samples.
+ * Windows longer than the retention are clipped to the most recent buckets.
+ *
+ * @return Number of buckets appended to `out`.
+ */
+size_t RollupTier::read(int64_t sinceMS, int64_t untilMS, std::vector<RollupBucket> &out) const
+{
+    int64_t firstMS = sinceMS - sinceMS % resolutionMS;
+    int64_t lastMS = untilMS - untilMS % resolutionMS;
+    firstMS = std::max(firstMS, lastMS - (getRetentionMS() - resolutionMS));
+
+    size_t start = out.size();
+    std::lock_guard<std::mutex> lock(bucketsMutex);
+    for (int64_t startMS = firstMS; startMS <= lastMS; startMS += resolutionMS)
+    {
+        const RollupBucket &bucket = buckets[static_cast<size_t>(startMS / resolutionMS) % bucketCount];
+        if (bucket.startMS == startMS && bucket.count > 0)
+        {
+            out.push_back(bucket);
+        }
+    }
+
+    return out.size() - start;
+}
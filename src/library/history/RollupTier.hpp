@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+// Aggregate of all samples of one metric within one time bucket
+struct RollupBucket
+{
+    int64_t startMS;
+    double sum;
+    float min;
+    float max;
+    float last;
+    uint32_t count;
+
+    double average() const { return count > 0 ? sum / count : 0.0; }
+};
+
+// Buckets are stored as they are in the history file, so their layout must not change
+static_assert(sizeof(RollupBucket) == 32, "RollupBucket is part of the history file format");
+
+/**
+ * Downsampled history of one metric with a fixed bucket width and retention.
+ *
+ * Buckets live in a ring addressed by (bucket start / width) % size, so a sample updates
+ * its bucket in O(1) and the memory of a tier never grows. The ring is allocated with the
+ * tier and can be moved into a history file (`attach`), where it survives restarts.
+ */
+class RollupTier
+{
+public:
+    RollupTier(int64_t resolutionMS, int64_t retentionMS);
+
+    // Adds a sample to its bucket, called by the single writer of the metric
+    void add(int64_t timeMS, double value);
+
+    // Copies the buckets that overlap [sinceMS, untilMS], oldest first
+    size_t read(int64_t sinceMS, int64_t untilMS, std::vector<RollupBucket> &out) const;
+
+    // Uses `getBucketCount()` buckets of a history file mapping from now on, keeping the
+    // buckets already stored there; must be called before sampling starts
+    void attach(RollupBucket *storage);
+    bool isAttached() const { return buckets != owned.data(); }
+
+    int64_t getResolutionMS() const { return resolutionMS; }
+    int64_t getRetentionMS() const { return static_cast<int64_t>(bucketCount) * resolutionMS; }
+    size_t getBucketCount() const { return bucketCount; }
+    size_t getSizeBytes() const { return owned.size() * sizeof(RollupBucket); }
+
+private:
+    int64_t resolutionMS;
+    size_t bucketCount;
+    std::vector<RollupBucket> owned; // empty once attached to a file
+    RollupBucket *buckets;
+    mutable std::mutex bucketsMutex;
+};
@@ -0,0 +1,6 @@
+#pragma once
+
+struct RollupTierStructure {
+    int resolutionSec;  // width of one bucket, e.g. 60 for 1-minute rollups
+    int retentionHours; // age after which buckets are overwritten
+};
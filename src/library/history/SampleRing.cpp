@@ -0,0 +1,228 @@
+#include "SampleRing.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief Allocates the slots of the ring.
+ *
+ * This is the only allocation of the ring; pushing and reading never allocate on the
+ * writer side.
+ *
+ * @param capacity Number of samples retained (values below 2 are clamped to 2).
+ */
+SampleRing::SampleRing(size_t capacity)
+    : capacity(std::max<size_t>(capacity, 2)), slots(new Slot[std::max<size_t>(capacity, 2)]), head(0)
+{
+    for (size_t i = 0; i < this->capacity; i++)
+    {
+        slots[i].timeMS.store(0, std::memory_order_relaxed);
+        slots[i].value.store(0.0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Appends a sample, overwriting the oldest one once the ring is full.
+ *
+ * The slot is written first and `head` is advanced with release semantics afterwards, so
+ * a reader that observes the new head also observes the sample. A release fence before the
+ * slot stores pairs with the acquire fence of the readers' re-check, so a reader that
+ * copied an overwritten slot sees the head that tells it so. There is no tail index:
+ * readers never consume samples, the retained window is simply the last `capacity` indices
+ * before `head`.
+ */
+void SampleRing::push(int64_t timeMS, double value)
+{
+    uint64_t index = head.load(std::memory_order_relaxed);
+    // keeps the slot stores after the previous head store (seqlock writer): a reader that
+    // sees the new contents of the slot also sees a head of at least `index`
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot &slot = slots[index % capacity];
+    slot.timeMS.store(timeMS, std::memory_order_relaxed);
+    slot.value.store(value, std::memory_order_relaxed);
+    head.store(index + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Aggregates a recent window in place.
+ *
+ * Finds the first sample of the window like `readSince` and folds the following samples
+ * into min, max, sum and count, without allocating. Samples overwritten by the writer while
+ * they are read can be newer than expected, so every sample is checked against `sinceMS`
+ * and the head is read again at the end: if the writer lapped the window start, the
+ * aggregate contains replaced samples and is computed again.
+ *
+ * @return False if the window holds no sample.
+ */
+bool SampleRing::summarizeSince(int64_t sinceMS, SampleSummary &summary) const
+{
+    for (int attempt = 0; attempt < 3; attempt++)
+    {
+        uint64_t last = head.load(std::memory_order_acquire);
+        // the oldest slot of a full ring is the next one the writer overwrites, so skip it
+        uint64_t low = last >= capacity ? last - capacity + 1 : 0;
+        uint64_t high = last;
+        while (low < high)
+        {
+            uint64_t middle = low + (high - low) / 2;
+            if (slots[middle % capacity].timeMS.load(std::memory_order_relaxed) < sinceMS)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+
+        summary.count = 0;
+        summary.sum = 0.0;
+        for (uint64_t index = low; index < last; index++)
+        {
+            const Slot &slot = slots[index % capacity];
+            if (slot.timeMS.load(std::memory_order_relaxed) < sinceMS)
+            {
+                continue;
+            }
+            double value = slot.value.load(std::memory_order_relaxed);
+            summary.min = summary.count == 0 ? value : std::min(summary.min, value);
+            summary.max = summary.count == 0 ? value : std::max(summary.max, value);
+            summary.sum += value;
+            summary.count++;
+        }
+
+        // the slots read are intact unless the writer has reached index `low + capacity`,
+        // which reuses the slot of `low` (the same bound as `copyRange`); the fence keeps
+        // this load after the slot loads above
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (head.load(std::memory_order_relaxed) - low < capacity)
+        {
+            break;
+        }
+    }
+
+    return summary.count > 0;
+}
+
+/**
+ * @brief Copies the samples with index in [first, last) and drops those that were overwritten.
+ *
+ * While the copy runs, the writer may wrap around and overwrite the oldest copied slots.
+ * After copying, `head` is loaded again: the writer may currently be writing index `head`,
+ * which reuses the slot of `head - capacity`, so only indices above that are known to be
+ * intact. Overwritten samples at the front of the copy are removed.
+ *
+ * @return Number of samples appended to `out`.
+ */
+size_t SampleRing::copyRange(uint64_t first, uint64_t last, std::vector<Sample> &out) const
+{
+    size_t start = out.size();
+    for (uint64_t index = first; index < last; index++)
+    {
+        const Slot &slot = slots[index % capacity];
+        out.push_back(Sample{slot.timeMS.load(std::memory_order_relaxed), slot.value.load(std::memory_order_relaxed)});
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t headAfter = head.load(std::memory_order_relaxed);
+    uint64_t firstIntact = headAfter >= capacity ? headAfter - capacity + 1 : 0;
+    if (first < firstIntact)
+    {
+        size_t overwritten = static_cast<size_t>(std::min(firstIntact, last) - first);
+        out.erase(out.begin() + start, out.begin() + start + overwritten);
+    }
+
+    return out.size() - start;
+}
+
+size_t SampleRing::readLast(size_t count, std::vector<Sample> &out) const
+{
+    uint64_t last = head.load(std::memory_order_acquire);
+    uint64_t available = std::min<uint64_t>(last, capacity);
+    uint64_t first = last - std::min<uint64_t>(count, available);
+    return copyRange(first, last, out);
+}
+
+/**
+ * @brief Copies the retained samples taken at or after `sinceMS`.
+ *
+ * Samples are pushed in time order, so the start of the window is found with a binary
+ * search over the retained indices instead of a scan.
+ */
+size_t SampleRing::readSince(int64_t sinceMS, std::vector<Sample> &out) const
+{
+    uint64_t last = head.load(std::memory_order_acquire);
+    uint64_t low = last - std::min<uint64_t>(last, capacity);
+    uint64_t high = last;
+    while (low < high)
+    {
+        uint64_t middle = low + (high - low) / 2;
+        if (slots[middle % capacity].timeMS.load(std::memory_order_relaxed) < sinceMS)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    size_t copied = copyRange(low, last, out);
+
+    // samples racing with the writer may be older than requested
+    size_t start = out.size() - copied;
+    size_t stale = 0;
+    while (start + stale < out.size() && out[start + stale].timeMS < sinceMS)
+    {
+        stale++;
+    }
+    out.erase(out.begin() + start, out.begin() + start + stale);
+    return copied - stale;
+}
+
+bool SampleRing::oldest(Sample &sample) const
+{
+    while (true)
+    {
+        uint64_t last = head.load(std::memory_order_acquire);
+        if (last == 0)
+        {
+            return false;
+        }
+
+        // once the ring is full, the oldest slot is the next one the writer overwrites
+        uint64_t first = last >= capacity ? last - capacity + 1 : 0;
+        const Slot &slot = slots[first % capacity];
+        sample.timeMS = slot.timeMS.load(std::memory_order_relaxed);
+        sample.value = slot.value.load(std::memory_order_relaxed);
+
+        // retry if the writer wrapped around onto the slot while it was read
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (head.load(std::memory_order_relaxed) < first + capacity)
+        {
+            return true;
+        }
+    }
+}
+
+bool SampleRing::latest(Sample &sample) const
+{
+    while (true)
+    {
+        uint64_t last = head.load(std::memory_order_acquire);
+        if (last == 0)
+        {
+            return false;
+        }
+
+        const Slot &slot = slots[(last - 1) % capacity];
+        sample.timeMS = slot.timeMS.load(std::memory_order_relaxed);
+        sample.value = slot.value.load(std::memory_order_relaxed);
+
+        // retry if the writer wrapped around onto the slot while it was read
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (head.load(std::memory_order_relaxed) < last - 1 + capacity)
+        {
+            return true;
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// One timestamped value of a metric
+struct Sample
+{
+    int64_t timeMS; // milliseconds since the epoch
+    double value;
+};
+
+// Aggregate of the samples of a window, see SampleRing::summarizeSince
+struct SampleSummary
+{
+    double min;
+    double max;
+    double sum;
+    uint64_t count;
+};
+
+/**
+ * Fixed-capacity ring of samples with one writer and any number of readers.
+ *
+ * The writer never waits and readers never block the writer: samples are published by
+ * advancing `head`, and readers detect samples that were overwritten while they copied.
+ */
+class SampleRing
+{
+public:
+    explicit SampleRing(size_t capacity);
+
+    SampleRing(const SampleRing &) = delete;
+    SampleRing &operator=(const SampleRing &) = delete;
+
+    // Appends a sample, must only be called from the single writer thread
+    void push(int64_t timeMS, double value);
+
+    // Copies all retained samples taken at or after `sinceMS`, oldest first
+    size_t readSince(int64_t sinceMS, std::vector<Sample> &out) const;
+
+    // Aggregates the retained samples taken at or after `sinceMS` without copying them
+    bool summarizeSince(int64_t sinceMS, SampleSummary &summary) const;
+
+    // Copies up to `count` of the most recent samples, oldest first
+    size_t readLast(size_t count, std::vector<Sample> &out) const;
+
+    // Gets the most recent sample, false if the ring is empty
+    bool latest(Sample &sample) const;
+
+    // Gets the oldest retained sample, false if the ring is empty
+    bool oldest(Sample &sample) const;
+
+    size_t getCapacity() const { return capacity; }
+
+    // Number of samples ever pushed
+    uint64_t getCount() const { return head.load(std::memory_order_acquire); }
+
+private:
+    // Fields are atomic so a reader racing with the writer reads stale values, never torn ones
+    struct Slot
+    {
+        std::atomic<int64_t> timeMS;
+        std::atomic<double> value;
+    };
+
+    size_t copyRange(uint64_t first, uint64_t last, std::vector<Sample> &out) const;
+
+    const size_t capacity;
+    std::unique_ptr<Slot[]> slots;
+
+    // Index of the next sample to write; samples [head - capacity, head) are retained.
+    // Padded by a full cache line on both sides so it never shares a line with other data.
+    // (Padding instead of alignas(64): C++14 operator new does not honor extended alignment.)
+    char paddingBefore[64];
+    std::atomic<uint64_t> head;
+    char paddingAfter[64 - sizeof(std::atomic<uint64_t>)];
+};
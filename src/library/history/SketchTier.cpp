@@ -0,0 +1,104 @@
+#include "SketchTier.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+/**
+ * @brief Allocates all windows of the tier.
+ *
+ * @param resolutionMS Width of one window in milliseconds.
+ * @param retentionMS Time covered by the tier; the number of windows is retention / resolution.
+ */
+SketchTier::SketchTier(int64_t resolutionMS, int64_t retentionMS)
+    : resolutionMS(std::max<int64_t>(resolutionMS, 1)),
+      windows(static_cast<size_t>(std::max<int64_t>(retentionMS / std::max<int64_t>(resolutionMS, 1), 1))),
+      counts(windows.size() * QuantileSketch::BUCKETS, 0)
+{
+    for (SketchWindow &window : windows)
+    {
+        window.startMS = -1;
+        window.count = 0;
+    }
+}
+
+/**
+ * @brief Adds a sample to the window its timestamp falls into.
+ *
+ * A slot that still holds an older window is cleared first, like `RollupTier::add`. Bucket
+ * counts saturate at 65535, which a window only reaches with a check duration far below a
+ * millisecond per minute of resolution.
+ */
+void SketchTier::add(int64_t timeMS, double value)
+{
+    int64_t startMS = timeMS - timeMS % resolutionMS;
+    size_t slot = static_cast<size_t>(startMS / resolutionMS) % windows.size();
+    SketchWindow &window = windows[slot];
+    uint16_t *row = &counts[slot * QuantileSketch::BUCKETS];
+
+    std::lock_guard<std::mutex> lock(windowsMutex);
+    if (window.startMS != startMS)
+    {
+        window.startMS = startMS;
+        window.min = static_cast<float>(value);
+        window.max = static_cast<float>(value);
+        window.zeroCount = 0;
+        window.count = 0;
+        std::memset(row, 0, QuantileSketch::BUCKETS * sizeof(uint16_t));
+    }
+
+    int index = QuantileSketch::bucketIndex(value);
+    if (index < 0)
+    {
+        window.zeroCount++;
+    }
+    else if (row[index] < std::numeric_limits<uint16_t>::max())
+    {
+        row[index]++;
+    }
+    window.min = std::min(window.min, static_cast<float>(value));
+    window.max = std::max(window.max, static_cast<float>(value));
+    window.count++;
+}
+
+/**
+ * @brief Merges the windows of a time window into one sketch.
+ *
+ * The cost is O(windows × buckets) and independent of the number of samples: the 1440
+ * windows of a day merge in well under a millisecond. Windows longer than the retention
+ * are clipped to the most recent windows.
+ *
+ * @return Number of windows merged into `out`.
+ */
+size_t SketchTier::merge(int64_t sinceMS, int64_t untilMS, QuantileSketch &out) const
+{
+    int64_t firstMS = sinceMS - sinceMS % resolutionMS;
+    int64_t lastMS = untilMS - untilMS % resolutionMS;
+    firstMS = std::max(firstMS, lastMS - (getRetentionMS() - resolutionMS));
+
+    size_t merged = 0;
+    std::lock_guard<std::mutex> lock(windowsMutex);
+    for (int64_t startMS = firstMS; startMS <= lastMS; startMS += resolutionMS)
+    {
+        size_t slot = static_cast<size_t>(startMS / resolutionMS) % windows.size();
+        const SketchWindow &window = windows[slot];
+        if (window.startMS != startMS || window.count == 0)
+        {
+            continue;
+        }
+
+        // every bucket carries the window's range, merging the same range again changes nothing
+        const uint16_t *row = &counts[slot * QuantileSketch::BUCKETS];
+        out.addBucket(-1, window.zeroCount, window.min, window.max);
+        for (int index = 0; index < QuantileSketch::BUCKETS; index++)
+        {
+            if (row[index] > 0)
+            {
+                out.addBucket(index, row[index], window.min, window.max);
+            }
+        }
+        merged++;
+    }
+
+    return merged;
+}
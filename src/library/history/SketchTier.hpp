@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include "history/QuantileSketch.hpp"
+
+/**
+ * Quantile sketches of one metric in fixed time windows, e.g. one per minute for a day.
+ *
+ * Windows live in a ring addressed like `RollupTier` buckets. Each window stores its bucket
+ * counts as 16-bit values (a QuantileSketch::BUCKETS wide row of one flat array), so a tier
+ * never grows and one window costs about 260 bytes.
+ */
+class SketchTier
+{
+public:
+    SketchTier(int64_t resolutionMS, int64_t retentionMS);
+
+    // Adds a sample to its window, called by the single writer of the metric
+    void add(int64_t timeMS, double value);
+
+    // Merges the windows that overlap [sinceMS, untilMS] into `out`, returns the number of windows
+    size_t merge(int64_t sinceMS, int64_t untilMS, QuantileSketch &out) const;
+
+    int64_t getResolutionMS() const { return resolutionMS; }
+    int64_t getRetentionMS() const { return static_cast<int64_t>(windows.size()) * resolutionMS; }
+    size_t getSizeBytes() const { return windows.size() * sizeof(SketchWindow) + counts.size() * sizeof(uint16_t); }
+
+private:
+    struct SketchWindow
+    {
+        int64_t startMS;
+        float min;
+        float max;
+        uint32_t zeroCount;
+        uint32_t count;
+    };
+
+    int64_t resolutionMS;
+    std::vector<SketchWindow> windows;
+    std::vector<uint16_t> counts;
+    mutable std::mutex windowsMutex;
+};
@@ -0,0 +1,136 @@
+#include "MemInfo.hpp"
+
+#include <cstring>
+#include "proc/ProcScanner.hpp"
+
+/**
+ * @brief Resolves a /proc/meminfo key to the field of `MemInfo` that stores it.
+ *
+ * The key is hashed once and dispatched through a `switch` on compile-time hashes of
+ * the known keys. Duplicate case labels do not compile, so the hash is guaranteed to
+ * be collision free (perfect) over the known keys; the final string comparison only
+ * rejects unknown keys that happen to share a hash.
+ *
+ * @param info Structure holding the fields.
+ * @param key Key without the trailing colon.
+ * @param length Length of the key.
+ * @return Pointer to the field, or nullptr for keys that are not modelled.
+ */
+static uint64_t *memInfoField(MemInfo &info, const char *key, size_t length)
+{
+    uint64_t *field = nullptr;
+    const char *name = nullptr;
+
+    switch (memInfoKeyHash(key, length))
+    {
+    case memInfoKeyHash("MemTotal"):
+        field = &info.memTotal, name = "MemTotal";
+        break;
+    case memInfoKeyHash("MemFree"):
+        field = &info.memFree, name = "MemFree";
+        break;
+    case memInfoKeyHash("MemAvailable"):
+        field = &info.memAvailable, name = "MemAvailable";
+        break;
+    case memInfoKeyHash("Buffers"):
+        field = &info.buffers, name = "Buffers";
+        break;
+    case memInfoKeyHash("Cached"):
+        field = &info.cached, name = "Cached";
+        break;
+    case memInfoKeyHash("SwapCached"):
+        field = &info.swapCached, name = "SwapCached";
+        break;
+    case memInfoKeyHash("SwapTotal"):
+        field = &info.swapTotal, name = "SwapTotal";
+        break;
+    case memInfoKeyHash("SwapFree"):
+        field = &info.swapFree, name = "SwapFree";
+        break;
+    case memInfoKeyHash("Dirty"):
+        field = &info.dirty, name = "Dirty";
+        break;
+    case memInfoKeyHash("Writeback"):
+        field = &info.writeback, name = "Writeback";
+        break;
+    case memInfoKeyHash("AnonPages"):
+        field = &info.anonPages, name = "AnonPages";
+        break;
+    case memInfoKeyHash("Shmem"):
+        field = &info.shmem, name = "Shmem";
+        break;
+    case memInfoKeyHash("Slab"):
+        field = &info.slab, name = "Slab";
+        break;
+    case memInfoKeyHash("SReclaimable"):
+        field = &info.sReclaimable, name = "SReclaimable";
+        break;
+    case memInfoKeyHash("SUnreclaim"):
+        field = &info.sUnreclaim, name = "SUnreclaim";
+        break;
+    case memInfoKeyHash("CommitLimit"):
+        field = &info.commitLimit, name = "CommitLimit";
+        break;
+    case memInfoKeyHash("Committed_AS"):
+        field = &info.committedAS, name = "Committed_AS";
+        break;
+    case memInfoKeyHash("HugePages_Total"):
+        field = &info.hugePagesTotal, name = "HugePages_Total";
+        break;
+    case memInfoKeyHash("HugePages_Free"):
+        field = &info.hugePagesFree, name = "HugePages_Free";
+        break;
+    case memInfoKeyHash("HugePages_Rsvd"):
+        field = &info.hugePagesRsvd, name = "HugePages_Rsvd";
+        break;
+    case memInfoKeyHash("HugePages_Surp"):
+        field = &info.hugePagesSurp, name = "HugePages_Surp";
+        break;
+    case memInfoKeyHash("Hugepagesize"):
+        field = &info.hugePageSize, name = "Hugepagesize";
+        break;
+    default:
+        return nullptr;
+    }
+
+    if (std::strlen(name) != length || std::memcmp(name, key, length) != 0)
+    {
+        return nullptr;
+    }
+    return field;
+}
+
+/**
+ * @brief Parses the content of /proc/meminfo into a `MemInfo`.
+ *
+ * Every line has the form "Key:   value kB". The file is scanned once; each key is
+ * resolved by `memInfoField` and its value written directly into the structure.
+ * Fields whose key is absent (older kernels, disabled features) are left at zero.
+ *
+ * @param data Content of /proc/meminfo.
+ * @param size Length of the content.
+ * @param info Structure receiving the values.
+ * @return True if at least MemTotal was found.
+ */
+bool parseMemInfo(const char *data, size_t size, MemInfo &info)
+{
+    std::memset(&info, 0, sizeof(info));
+
+    ProcScanner scanner(data, size);
+    while (!scanner.atEnd())
+    {
+        const char *key;
+        size_t length;
+        if (scanner.readToken(key, length, ':') && scanner.skip(':'))
+        {
+            uint64_t *field = memInfoField(info, key, length);
+            if (field != nullptr)
+            {
+                scanner.readUInt(*field);
+            }
+        }
+        scanner.nextLine();
+    }
+
+    return info.memTotal != 0;
+}
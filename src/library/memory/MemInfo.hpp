@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Values of /proc/meminfo, in kB (HugePages_* are page counts)
+struct MemInfo
+{
+    uint64_t memTotal;
+    uint64_t memFree;
+    uint64_t memAvailable;
+    uint64_t buffers;
+    uint64_t cached;
+    uint64_t swapCached;
+    uint64_t swapTotal;
+    uint64_t swapFree;
+    uint64_t dirty;
+    uint64_t writeback;
+    uint64_t anonPages;
+    uint64_t shmem;
+    uint64_t slab;
+    uint64_t sReclaimable;
+    uint64_t sUnreclaim;
+    uint64_t commitLimit;
+    uint64_t committedAS;
+    uint64_t hugePagesTotal;
+    uint64_t hugePagesFree;
+    uint64_t hugePagesRsvd;
+    uint64_t hugePagesSurp;
+    uint64_t hugePageSize;
+
+    // Used swap in percent of SwapTotal
+    double swapUsagePercent() const { return swapTotal ? 100.0 * (swapTotal - swapFree) / swapTotal : 0.0; }
+
+    // Committed_AS in percent of CommitLimit
+    double commitPercent() const { return commitLimit ? 100.0 * committedAS / commitLimit : 0.0; }
+};
+
+// FNV-1a hash of a /proc/meminfo key, usable in case labels
+constexpr uint32_t memInfoKeyHash(const char *key, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ static_cast<unsigned char>(key[i])) * 16777619u;
+    }
+    return hash;
+}
+
+template <size_t N>
+constexpr uint32_t memInfoKeyHash(const char (&key)[N])
+{
+    return memInfoKeyHash(key, N - 1);
+}
+
+// Parses the content of /proc/meminfo in one pass, unknown keys are skipped
+bool parseMemInfo(const char *data, size_t size, MemInfo &info);
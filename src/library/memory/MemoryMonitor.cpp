@@ -1,45 +1,10 @@
 #include "MemoryMonitor.hpp"
 
-MemoryMonitor::MemoryMonitor(int durationTimeToCheckMS)
-    : durationTimeToCheckMS(durationTimeToCheckMS), lastMemoryUsage(0.0), monitoringMemoryStatus(false) {}
+#include <cstring>
 
-/**
- * @brief Starts monitoring memory usage by launching a background thread.
- *
- * This function creates a new thread that executes the `thread_getMemoryUsage` method,
- * which is responsible for continuously monitoring memory usage. The thread is detached
- * to allow it to run independently in the background without blocking the main thread.
- *
- * The `thread_getMemoryUsage` method performs periodic checks on the system's memory usage
- * and updates relevant metrics. By detaching the thread, the function ensures that the
- * monitoring continues in the background as long as the application is running, without
- * requiring explicit thread management or synchronization from the main thread.
- *
- * Note:
- * - The `monitorThread` is a member variable of the `MemoryMonitor` class that holds the
- *   thread object.
- * - The `thread_getMemoryUsage` method should handle its own error checking and ensure
- *   proper termination conditions to avoid potential issues like resource leaks.
- *
- * Example:
- * @code
- * MemoryMonitor memoryMonitor;
- * memoryMonitor.startMonitoring();
- * // Memory monitoring starts in the background and continues until the application exits.
- * @endcode
- */
-void MemoryMonitor::startMonitoring()
+MemoryMonitor::MemoryMonitor() : lastMemoryUsage(0.0), memInfoFile("/proc/meminfo"), metrics(nullptr), usageMetric(-1), swapMetric(-1)
 {
-    // if monitoring enabled
-    if (this->monitoringMemoryStatus)
-    {
-        return;
-    }
-
-    // if monitoring disabled
-    this->monitoringMemoryStatus = true;
-    monitorThread = std::thread(&MemoryMonitor::thread_getMemoryUsage, this);
-    monitorThread.detach(); // Detach the thread so it runs in the background
+    std::memset(&lastMemInfo, 0, sizeof(lastMemInfo));
 }
 
 /**
@@ -50,9 +15,8 @@ void MemoryMonitor::startMonitoring()
  * calculated and stored by the `MemoryMonitor` class.
  *
  * The value returned by this method is the result of the most recent memory
- * monitoring operation performed by the `thread_getMemoryUsage` method. This
- * method is useful for getting the current state of memory usage for reporting or
- * analysis purposes.
+ * sample taken by the `sample` method. This method is useful for getting the current
+ * state of memory usage for reporting or analysis purposes.
  *
  * @return The last recorded memory usage percentage as a `double`.
  *
@@ -70,103 +34,77 @@ double MemoryMonitor::getLastMemoryUsage() const
 }
 
 /**
- * @brief Continuously monitors the memory usage of the system.
+ * @brief Takes one memory usage sample.
  *
- * This method runs in a separate thread and periodically reads memory statistics
+ * This method is executed periodically by the `Scheduler` thread and reads memory statistics
  * from the `/proc/meminfo` file to calculate the current memory usage percentage.
  * It performs the following tasks:
  *
- * 1. Checks if monitoring is enabled. If not, it sleeps for a specified duration
- *    and continues to the next iteration.
- * 2. Opens the `/proc/meminfo` file to read memory information.
- * 3. Parses the file to extract the total and available memory.
- * 4. Calculates the used memory and the memory usage percentage.
- * 5. Updates the `lastMemoryUsage` member variable with the calculated percentage.
- * 6. Sleeps for a specified duration between checks, as defined by `durationTimeToCheckMS`.
- *
- * This method will run indefinitely in a loop until the program terminates. If the file
- * cannot be opened or the total memory cannot be found, an error message is printed,
- * and the method returns.
+ * 1. Re-reads `/proc/meminfo` through the persistent descriptor of `memInfoFile`.
+ * 2. Parses the whole file in one pass into a `MemInfo` (see `parseMemInfo`).
+ * 3. Calculates the used memory (MemTotal - MemAvailable) and the memory usage percentage.
+ * 4. Updates `lastMemoryUsage` and the published `MemInfo`.
  *
- * Note: This method uses blocking operations (file I/O and sleep) and should be run in
- * a separate thread to avoid blocking the main application.
- *
- * Example usage:
- * @code
- * MemoryMonitor memoryMonitor;
- * // Start monitoring in a separate thread
- * std::thread monitorThread(&MemoryMonitor::thread_getMemoryUsage, &memoryMonitor);
- * monitorThread.detach();
- * // Continue with other tasks
- * @endcode
+ * If the file cannot be read or the total memory cannot be found, an error message is printed,
+ * and the sample is skipped. The period between two samples is the `memory_check_duration`
+ * setting the task was registered with.
  */
-void MemoryMonitor::thread_getMemoryUsage()
+void MemoryMonitor::sample()
 {
-    while (this->monitoringMemoryStatus)
+    if (memInfoFile.read() <= 0)
     {
-        std::ifstream memInfoFile("/proc/meminfo");
-        if (!memInfoFile.is_open())
-        {
-            std::cout << "Error opening /proc/meminfo" << std::endl;
-            return;
-        }
-
-        std::string line;
-        long long totalMemory = 0;
-        long long freeMemory = 0;
-
-        while (std::getline(memInfoFile, line))
-        {
-            std::istringstream iss(line);
-            std::string key;
-            long long value;
-            std::string unit;
-
-            iss >> key >> value >> unit;
-
-            if (key == "MemTotal:")
-            {
-                totalMemory = value;
-            }
-            if (key == "MemAvailable:")
-            {
-                freeMemory = value;
-            }
-        }
-
-        memInfoFile.close();
+        std::cout << "Error reading /proc/meminfo" << std::endl;
+        return;
+    }
 
-        if (totalMemory == 0)
-        {
-            std::cout << "Total memory not found in /proc/meminfo" << std::endl;
-            return;
-        }
+    MemInfo info;
+    if (!parseMemInfo(memInfoFile.data(), memInfoFile.size(), info))
+    {
+        std::cout << "Total memory not found in /proc/meminfo" << std::endl;
+        return;
+    }
 
-        // Calculate used memory and memory usage percentage
-        long long usedMemory = totalMemory - freeMemory;
-        double memoryUsagePercent = 100.0 * usedMemory / totalMemory;
+    // Calculate used memory and memory usage percentage
+    uint64_t usedMemory = info.memTotal - info.memAvailable;
+    double memoryUsagePercent = 100.0 * usedMemory / info.memTotal;
 
-        // Update memory usage
-        lastMemoryUsage = memoryUsagePercent;
+    // Update memory usage
+    {
+        std::lock_guard<std::mutex> lock(memInfoMutex);
+        lastMemInfo = info;
+    }
+    lastMemoryUsage = memoryUsagePercent;
 
-        // Sleep for the memory check duration from the settings
-        std::this_thread::sleep_for(std::chrono::milliseconds(this->durationTimeToCheckMS));
+    if (metrics != nullptr)
+    {
+        int64_t timeMS = MetricStore::nowMS();
+        metrics->record(usageMetric, timeMS, memoryUsagePercent);
+        metrics->record(swapMetric, timeMS, info.swapUsagePercent());
     }
 }
 
 /**
- * @brief Stops the memory monitoring process.
+ * @brief Records the usage of every sample into a metric store.
  *
- * This function sets the `monitoringMemoryStatus` flag to `false`,
- * indicating that memory monitoring should be stopped. As a result,
- * any ongoing memory usage tracking will cease, and the system will
- * no longer collect or process memory usage data.
+ * Registers "memory" (usage percentage) and "swap" (swap usage percentage). Must be
+ * called before the scheduler starts.
  *
- * It is essential to call this method when memory monitoring is
- * no longer required to free up resources and ensure the monitoring
- * process is gracefully terminated.
+ * @param store Store that receives the samples.
  */
-void MemoryMonitor::stopMonitoring()
+void MemoryMonitor::setMetricStore(MetricStore &store)
 {
-    this->monitoringMemoryStatus = false;
-}
\ No newline at end of file
+    usageMetric = store.registerMetric("memory");
+    swapMetric = store.registerMetric("swap");
+    metrics = &store;
+}
+
+/**
+ * @brief Returns the complete /proc/meminfo model of the last sample.
+ *
+ * @return Copy of the last parsed `MemInfo`, all zero before the first sample.
+ */
+MemInfo MemoryMonitor::getLastMemInfo() const
+{
+    std::lock_guard<std::mutex> lock(memInfoMutex);
+    return lastMemInfo;
+}
@@ -1,27 +1,38 @@
 #pragma once
 
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
-#include <thread>
-#include <chrono>
+#include <atomic>
+#include <mutex>
 #include "settings/Settings.hpp" // Include your Settings class header
 #include "log/Log.hpp"      // Include your Log class header
+#include "proc/ProcFile.hpp"
+#include "memory/MemInfo.hpp"
+#include "history/MetricStore.hpp"
 
 class MemoryMonitor
 {
 public:
-    MemoryMonitor(int durationTimeToCheckMS);
-    void startMonitoring();
-    void stopMonitoring();
+    MemoryMonitor();
+
+    // Takes one memory usage sample, called periodically by the scheduler
+    void sample();
     double getLastMemoryUsage() const;
 
+    // Gets all /proc/meminfo values of the last sample
+    MemInfo getLastMemInfo() const;
+
+    // Registers "memory" and "swap" and records every sample into the store
+    void setMetricStore(MetricStore &store);
+
 private:
-    void thread_getMemoryUsage();
+    std::atomic<double> lastMemoryUsage;
+    MemInfo lastMemInfo;
+    mutable std::mutex memInfoMutex;
+    ProcFile memInfoFile;
 
-    bool monitoringMemoryStatus;
-    int durationTimeToCheckMS;
-    double lastMemoryUsage;
-    std::thread monitorThread;
+    // History, recorded when a store is set
+    MetricStore *metrics;
+    int usageMetric;
+    int swapMetric;
 };
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string>
+
+struct NetLimitStructure {
+    std::string interface; // interface name or shell pattern, e.g. "eth0" or "veth*"
+    int rxMbps;            // 0 disables the check
+    int txMbps;
+    int errorsPerSec;      // rx + tx errors
+    int dropsPerSec;       // rx + tx drops
+};
@@ -0,0 +1,269 @@
+#include "NetMonitor.hpp"
+
+#include <fnmatch.h>
+#include <cstring>
+
+/**
+ * @brief Allocates the fixed interface table.
+ *
+ * `/proc/net/dev` has one line per interface, which means hundreds of lines on hosts with
+ * many veth pairs (e.g. Kubernetes nodes). The read buffer, the interface table and the
+ * line-to-slot hints are therefore sized once from `capacity`, and a sample never allocates.
+ *
+ * @param capacity Maximum number of interfaces tracked at the same time.
+ * @param excludePatterns Shell patterns (`fnmatch`) of interface names to ignore, e.g. "lo".
+ * @param limits Per-interface thresholds; the first entry whose pattern matches applies.
+ */
+NetMonitor::NetMonitor(int capacity, const std::vector<std::string> &excludePatterns, const std::vector<NetLimitStructure> &limits)
+    : records(capacity > 0 ? capacity : 1), lineRecords(records.size(), -1), excludePatterns(excludePatterns), limits(limits),
+      netDevFile("/proc/net/dev", 256 + 160 * records.size()), hasPreviousSample(false), capacityWarned(false)
+{
+    for (InterfaceRecord &record : records)
+    {
+        std::memset(&record, 0, sizeof(record));
+    }
+}
+
+/**
+ * @brief Reads /proc/net/dev and derives the rates of every interface.
+ *
+ * After two header lines, each line holds the interface name followed by eight receive
+ * and eight transmit counters:
+ *
+ *     eth0: 2536 38 0 0 0 0 0 0 2252 36 0 0 0 0 0 0
+ *
+ * Large byte counters can touch the colon ("eth0:123456789"), so the name is read up to
+ * the colon rather than up to a space. Interface names are interned into the table the
+ * first time they show up; later samples only compare them (see `findRecord`).
+ */
+void NetMonitor::sample()
+{
+    if (netDevFile.read() <= 0)
+    {
+        logger.logToConsole("Error reading /proc/net/dev");
+        return;
+    }
+    if (netDevFile.isTruncated() && !capacityWarned)
+    {
+        logger.logToConsole("/proc/net/dev is larger than the read buffer, some interfaces are not monitored");
+        capacityWarned = true;
+    }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double elapsedSeconds = hasPreviousSample ? std::chrono::duration<double>(now - previousSampleTime).count() : 0.0;
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+
+    for (InterfaceRecord &record : records)
+    {
+        record.seen = false;
+    }
+
+    ProcScanner scanner(netDevFile.data(), netDevFile.size());
+    int line = 0;
+    while (!scanner.atEnd())
+    {
+        const char *name;
+        size_t length;
+        if (!scanner.readToken(name, length, ':') || !scanner.skip(':') || length >= IFNAMSIZ)
+        {
+            // header lines
+            scanner.nextLine();
+            continue;
+        }
+
+        int index = findRecord(line++, name, length);
+        if (index < 0)
+        {
+            if (!capacityWarned)
+            {
+                logger.logToConsole("Interface table is full, some interfaces are not monitored");
+                capacityWarned = true;
+            }
+            scanner.nextLine();
+            continue;
+        }
+
+        InterfaceRecord &record = records[index];
+        record.seen = true;
+        if (record.ignored)
+        {
+            scanner.nextLine();
+            continue;
+        }
+
+        // bytes packets errs drop fifo frame compressed multicast, for receive then transmit
+        uint64_t columns[16] = {};
+        for (int column = 0; column < 16; column++)
+        {
+            scanner.readUInt(columns[column]);
+        }
+        uint64_t counters[COUNTER_COUNT] = {columns[0], columns[1], columns[2], columns[3],
+                                            columns[8], columns[9], columns[10], columns[11]};
+        derive(record, counters, elapsedSeconds);
+        scanner.nextLine();
+    }
+
+    // release slots of interfaces that disappeared
+    for (InterfaceRecord &record : records)
+    {
+        if (record.used && !record.seen)
+        {
+            record.used = false;
+        }
+    }
+
+    previousSampleTime = now;
+    hasPreviousSample = true;
+}
+
+/**
+ * @brief Returns the rates of all monitored interfaces.
+ *
+ * @return One entry per present, not ignored interface that has been sampled at least twice.
+ */
+std::vector<NetStats> NetMonitor::getStats() const
+{
+    std::vector<NetStats> result;
+    getStats(result);
+    return result;
+}
+
+void NetMonitor::getStats(std::vector<NetStats> &out) const
+{
+    out.clear();
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    for (const InterfaceRecord &record : records)
+    {
+        if (record.used && !record.ignored && record.hasPrevious)
+        {
+            out.push_back(record.stats);
+        }
+    }
+}
+
+/**
+ * @brief Finds the slot of the interface on a given line of the file.
+ *
+ * The kernel lists interfaces in a stable order, so the slot used for the same line in
+ * the previous sample is tried first and a sample usually costs one name comparison per
+ * line. Only when interfaces were added or removed does the lookup fall back to a scan of
+ * the table, and only unknown names are interned.
+ *
+ * @return The slot index, or -1 if the table is full.
+ */
+int NetMonitor::findRecord(int line, const char *name, size_t length)
+{
+    bool hasHint = line < static_cast<int>(lineRecords.size());
+    if (hasHint && lineRecords[line] >= 0)
+    {
+        const InterfaceRecord &record = records[lineRecords[line]];
+        if (record.used && record.nameLength == length && std::memcmp(record.name, name, length) == 0)
+        {
+            return lineRecords[line];
+        }
+    }
+
+    int index = -1;
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const InterfaceRecord &record = records[i];
+        if (record.used && record.nameLength == length && std::memcmp(record.name, name, length) == 0)
+        {
+            index = static_cast<int>(i);
+            break;
+        }
+    }
+    if (index < 0)
+    {
+        index = internRecord(name, length);
+    }
+
+    if (hasHint)
+    {
+        lineRecords[line] = index;
+    }
+    return index;
+}
+
+/**
+ * @brief Assigns a free slot to a new interface.
+ *
+ * The name is copied once, and the exclude patterns and limits are matched once; the
+ * results are kept in the slot for as long as the interface exists.
+ *
+ * @return The slot index, or -1 if the table is full.
+ */
+int NetMonitor::internRecord(const char *name, size_t length)
+{
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        InterfaceRecord &record = records[i];
+        if (record.used)
+        {
+            continue;
+        }
+
+        std::memset(&record, 0, sizeof(record));
+        record.used = true;
+        std::memcpy(record.name, name, length);
+        record.name[length] = '\0';
+        record.nameLength = length;
+        std::memcpy(record.stats.name, record.name, sizeof(record.stats.name));
+
+        for (const std::string &pattern : excludePatterns)
+        {
+            if (fnmatch(pattern.c_str(), record.name, 0) == 0)
+            {
+                record.ignored = true;
+                break;
+            }
+        }
+
+        record.stats.limitIndex = -1;
+        for (size_t limit = 0; limit < limits.size(); limit++)
+        {
+            if (fnmatch(limits[limit].interface.c_str(), record.name, 0) == 0)
+            {
+                record.stats.limitIndex = static_cast<int>(limit);
+                break;
+            }
+        }
+
+        return static_cast<int>(i);
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Derives the per-second rates of an interface from the counter deltas.
+ *
+ * The first sample of an interface only stores its counters. Counters that went
+ * backwards (interface re-created under the same name) count as zero.
+ */
+void NetMonitor::derive(InterfaceRecord &record, const uint64_t *counters, double elapsedSeconds)
+{
+    if (record.hasPrevious && elapsedSeconds > 0)
+    {
+        double rate[COUNTER_COUNT];
+        for (int counter = 0; counter < COUNTER_COUNT; counter++)
+        {
+            uint64_t delta = counters[counter] >= record.counters[counter] ? counters[counter] - record.counters[counter] : 0;
+            rate[counter] = delta / elapsedSeconds;
+        }
+
+        record.stats.rxBytesPerSec = rate[RX_BYTES];
+        record.stats.txBytesPerSec = rate[TX_BYTES];
+        record.stats.rxPacketsPerSec = rate[RX_PACKETS];
+        record.stats.txPacketsPerSec = rate[TX_PACKETS];
+        record.stats.rxErrorsPerSec = rate[RX_ERRORS];
+        record.stats.txErrorsPerSec = rate[TX_ERRORS];
+        record.stats.rxDropsPerSec = rate[RX_DROPS];
+        record.stats.txDropsPerSec = rate[TX_DROPS];
+    }
+
+    std::memcpy(record.counters, counters, sizeof(record.counters));
+    record.hasPrevious = true;
+}
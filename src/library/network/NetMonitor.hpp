@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <net/if.h>
+#include "log/Log.hpp"
+#include "proc/ProcFile.hpp"
+#include "proc/ProcScanner.hpp"
+#include "network/NetLimitStructure.hpp"
+
+// Rates of one network interface, derived from two /proc/net/dev samples
+struct NetStats
+{
+    char name[IFNAMSIZ];
+    double rxBytesPerSec;
+    double txBytesPerSec;
+    double rxPacketsPerSec;
+    double txPacketsPerSec;
+    double rxErrorsPerSec;
+    double txErrorsPerSec;
+    double rxDropsPerSec;
+    double txDropsPerSec;
+
+    // Index of the first matching entry of `net_limits`, or -1
+    int limitIndex;
+};
+
+class NetMonitor
+{
+public:
+    NetMonitor(int capacity, const std::vector<std::string> &excludePatterns, const std::vector<NetLimitStructure> &limits);
+
+    // Reads /proc/net/dev and derives rates, called periodically by the scheduler
+    void sample();
+
+    // Gets the rates of all monitored interfaces of the last sample
+    std::vector<NetStats> getStats() const;
+
+    // Same into a reused vector, allocation-free once its capacity fits all interfaces
+    void getStats(std::vector<NetStats> &out) const;
+
+    // Limits resolved by `NetStats::limitIndex`
+    const NetLimitStructure &getLimit(int index) const { return limits[index]; }
+
+private:
+    // Columns of /proc/net/dev used for the derivation, receive block then transmit block
+    enum Counter
+    {
+        RX_BYTES = 0,
+        RX_PACKETS,
+        RX_ERRORS,
+        RX_DROPS,
+        TX_BYTES,
+        TX_PACKETS,
+        TX_ERRORS,
+        TX_DROPS,
+        COUNTER_COUNT
+    };
+
+    struct InterfaceRecord
+    {
+        bool used;        // slot holds an interface
+        bool seen;        // interface was present in the current read
+        bool ignored;     // filtered out by pattern
+        bool hasPrevious; // counters hold a previous sample
+        char name[IFNAMSIZ];
+        size_t nameLength;
+        uint64_t counters[COUNTER_COUNT];
+        NetStats stats;
+    };
+
+    int findRecord(int line, const char *name, size_t length);
+    int internRecord(const char *name, size_t length);
+    void derive(InterfaceRecord &record, const uint64_t *counters, double elapsedSeconds);
+
+    std::vector<InterfaceRecord> records;
+    std::vector<int> lineRecords;
+    std::vector<std::string> excludePatterns;
+    std::vector<NetLimitStructure> limits;
+    ProcFile netDevFile;
+    std::chrono::steady_clock::time_point previousSampleTime;
+    bool hasPreviousSample;
+    bool capacityWarned;
+    mutable std::mutex statsMutex;
+    Log logger;
+};
@@ -0,0 +1,215 @@
+#include "PressureMonitor.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <cstring>
+#include <cerrno>
+
+PressureMonitor::PressureMonitor() : metrics(nullptr)
+{
+    std::memset(stats, 0, sizeof(stats));
+
+    for (int resource = 0; resource < PRESSURE_RESOURCE_COUNT; resource++)
+    {
+        files[resource].reset(new ProcFile(std::string("/proc/pressure/") + resourceName(resource), 256));
+        if (!files[resource]->isOpen())
+        {
+            logger.logToConsole(files[resource]->getPath() + " is not available (kernel without PSI support?)");
+        }
+    }
+}
+
+PressureMonitor::~PressureMonitor()
+{
+    for (int fd : triggerFds)
+    {
+        close(fd);
+    }
+}
+
+const char *PressureMonitor::resourceName(int resource)
+{
+    static const char *names[PRESSURE_RESOURCE_COUNT] = {"cpu", "memory", "io"};
+    return (resource >= 0 && resource < PRESSURE_RESOURCE_COUNT) ? names[resource] : "";
+}
+
+int PressureMonitor::resourceFromName(const std::string &name)
+{
+    for (int resource = 0; resource < PRESSURE_RESOURCE_COUNT; resource++)
+    {
+        if (name == resourceName(resource))
+        {
+            return resource;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Reads the Pressure Stall Information of cpu, memory and io.
+ *
+ * Each file of `/proc/pressure` holds a "some" line (at least one task stalled on the
+ * resource) and a "full" line (all non-idle tasks stalled), each with the stall share over
+ * the last 10, 60 and 300 seconds and the total stall time in microseconds:
+ *
+ *     some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+ *
+ * The files are read through persistent descriptors, like the other collectors.
+ * Resources that are not available (kernel built without PSI) are skipped.
+ */
+void PressureMonitor::sample()
+{
+    for (int resource = 0; resource < PRESSURE_RESOURCE_COUNT; resource++)
+    {
+        PressureStats current;
+        std::memset(&current, 0, sizeof(current));
+        current.available = readResource(resource, current);
+
+        if (metrics != nullptr && current.available)
+        {
+            metrics->record(metricIds[resource], current.some.avg10);
+        }
+
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stats[resource] = current;
+    }
+}
+
+/**
+ * @brief Records the "some avg10" stall share of every sample into a metric store.
+ *
+ * Registers "psi.cpu", "psi.memory" and "psi.io". Must be called before the scheduler starts.
+ *
+ * @param store Store that receives the samples.
+ */
+void PressureMonitor::setMetricStore(MetricStore &store)
+{
+    for (int resource = 0; resource < PRESSURE_RESOURCE_COUNT; resource++)
+    {
+        metricIds[resource] = store.registerMetric(std::string("psi.") + resourceName(resource));
+    }
+    metrics = &store;
+}
+
+/**
+ * @brief Returns the last sample of a resource.
+ *
+ * @param resource One of `PressureResource`.
+ * @return Copy of the stats, with `available` false if the resource could not be read.
+ */
+PressureStats PressureMonitor::getStats(int resource) const
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return stats[resource];
+}
+
+static void readAverage(ProcScanner &scanner, const char *key, double &value)
+{
+    scanner.skipSpaces();
+    if (scanner.match(key))
+    {
+        scanner.readDecimal(value);
+    }
+}
+
+bool PressureMonitor::readResource(int resource, PressureStats &result)
+{
+    ProcFile &file = *files[resource];
+    if (!file.isOpen() || file.read() <= 0)
+    {
+        return false;
+    }
+
+    ProcScanner scanner(file.data(), file.size());
+    while (!scanner.atEnd())
+    {
+        PressureLine *line = nullptr;
+        if (scanner.match("some"))
+        {
+            line = &result.some;
+        }
+        else if (scanner.match("full"))
+        {
+            line = &result.full;
+        }
+
+        if (line != nullptr)
+        {
+            readAverage(scanner, "avg10=", line->avg10);
+            readAverage(scanner, "avg60=", line->avg60);
+            readAverage(scanner, "avg300=", line->avg300);
+            scanner.skipSpaces();
+            if (scanner.match("total="))
+            {
+                scanner.readUInt(line->totalUS);
+            }
+        }
+        scanner.nextLine();
+    }
+
+    return true;
+}
+
+/**
+ * @brief Registers a kernel PSI trigger and watches it from the scheduler.
+ *
+ * Writing "<some|full> <stall us> <window us>" to a `/proc/pressure` file opened for
+ * writing makes the kernel signal `POLLPRI` on that descriptor whenever the stall time
+ * within the window exceeds the threshold (at most once per window). The descriptor is
+ * handed to `Scheduler::watchFd`, so a stall is reported the moment it happens without
+ * any polling of the pressure files. The stall handler receives a ready-to-send message.
+ *
+ * @param scheduler Scheduler that polls the trigger descriptor.
+ * @param trigger Resource, type, stall threshold and window of the trigger.
+ * @return True if the trigger was registered.
+ */
+bool PressureMonitor::addTrigger(Scheduler &scheduler, const PressureTriggerStructure &trigger)
+{
+    int resource = resourceFromName(trigger.resource);
+    if (resource < 0 || (trigger.type != "some" && trigger.type != "full"))
+    {
+        logger.logToConsole("Invalid PSI trigger: " + trigger.resource + " " + trigger.type);
+        return false;
+    }
+
+    std::string path = std::string("/proc/pressure/") + resourceName(resource);
+    int fd = open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+    {
+        logger.logToConsole("Failed to open " + path + " for PSI trigger");
+        return false;
+    }
+
+    std::string definition = trigger.type + " " + std::to_string(trigger.stallUS) + " " + std::to_string(trigger.windowUS);
+    if (write(fd, definition.c_str(), definition.size() + 1) < 0)
+    {
+        // without CAP_SYS_RESOURCE the window has to be a multiple of 2 s
+        logger.logToConsole("Failed to register PSI trigger '" + definition + "' on " + path + ": " + std::strerror(errno));
+        close(fd);
+        return false;
+    }
+    triggerFds.push_back(fd);
+
+    std::string message = std::string("Pressure Warning!\n") + resourceName(resource) + " " + trigger.type + " stall above " +
+                          std::to_string(trigger.stallUS / 1000) + " ms within " + std::to_string(trigger.windowUS / 1000) + " ms";
+
+    scheduler.watchFd("psi " + definition, fd, POLLPRI, [this, resource, message](short revents)
+                      {
+                          if (!(revents & POLLPRI) || !stallHandler)
+                          {
+                              return;
+                          }
+
+                          PressureStats current;
+                          std::memset(&current, 0, sizeof(current));
+                          readResource(resource, current);
+
+                          char averages[64];
+                          snprintf(averages, sizeof(averages), "\nsome avg10 : %.2f%%\nfull avg10 : %.2f%%", current.some.avg10, current.full.avg10);
+                          stallHandler(message + averages);
+                      });
+
+    logger.logToConsole("PSI trigger '" + definition + "' registered on " + path);
+    return true;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include "log/Log.hpp"
+#include "proc/ProcFile.hpp"
+#include "proc/ProcScanner.hpp"
+#include "scheduler/Scheduler.hpp"
+#include "pressure/PressureTriggerStructure.hpp"
+#include "history/MetricStore.hpp"
+
+enum PressureResource
+{
+    PRESSURE_CPU = 0,
+    PRESSURE_MEMORY,
+    PRESSURE_IO,
+    PRESSURE_RESOURCE_COUNT
+};
+
+// One "some" or "full" line of a /proc/pressure file
+struct PressureLine
+{
+    double avg10;
+    double avg60;
+    double avg300;
+    uint64_t totalUS;
+};
+
+struct PressureStats
+{
+    bool available;
+    PressureLine some;
+    PressureLine full;
+};
+
+class PressureMonitor
+{
+public:
+    PressureMonitor();
+    ~PressureMonitor();
+
+    PressureMonitor(const PressureMonitor &) = delete;
+    PressureMonitor &operator=(const PressureMonitor &) = delete;
+
+    // Reads avg10/avg60/avg300/total of every resource, called periodically by the scheduler
+    void sample();
+
+    // Gets the last sample of a resource
+    PressureStats getStats(int resource) const;
+
+    // Registers a kernel PSI trigger that is watched by the scheduler
+    bool addTrigger(Scheduler &scheduler, const PressureTriggerStructure &trigger);
+
+    // Called on the scheduler thread when a trigger fires
+    void setStallHandler(std::function<void(const std::string &)> handler) { stallHandler = handler; }
+
+    // Registers "psi.<resource>" (some avg10) and records every sample into the store
+    void setMetricStore(MetricStore &store);
+
+    static const char *resourceName(int resource);
+    static int resourceFromName(const std::string &name);
+
+private:
+    bool readResource(int resource, PressureStats &stats);
+
+    std::unique_ptr<ProcFile> files[PRESSURE_RESOURCE_COUNT];
+    PressureStats stats[PRESSURE_RESOURCE_COUNT];
+    mutable std::mutex statsMutex;
+    std::vector<int> triggerFds;
+    std::function<void(const std::string &)> stallHandler;
+
+    // History, recorded when a store is set
+    MetricStore *metrics;
+    int metricIds[PRESSURE_RESOURCE_COUNT];
+    Log logger;
+};
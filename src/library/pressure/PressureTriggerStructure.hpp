@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string>
+
+struct PressureTriggerStructure {
+    std::string resource; // cpu, memory or io
+    std::string type;     // some or full
+    int stallUS;
+    int windowUS;
+};
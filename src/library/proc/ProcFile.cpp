@@ -0,0 +1,74 @@
+#include "ProcFile.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+
+/**
+ * @brief Opens a /proc (or /sys) file and keeps the descriptor for later reads.
+ *
+ * The read buffer is allocated once here, so sampling the file afterwards never
+ * allocates. Files larger than `capacity` are truncated to their first `capacity`
+ * bytes, which is fine for files whose interesting lines come first (`/proc/stat`).
+ *
+ * If the file cannot be opened, `isOpen()` returns false and `read()` fails.
+ *
+ * @param path Absolute path of the file.
+ * @param capacity Maximum number of bytes read per sample.
+ */
+ProcFile::ProcFile(const std::string &path, size_t capacity)
+    : path(path), fd(-1), capacity(capacity), length(0), buffer(capacity + 1, '\0')
+{
+    fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+ProcFile::~ProcFile()
+{
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+}
+
+/**
+ * @brief Reads the current content of the file.
+ *
+ * The file is re-read from offset 0 with `pread`, which makes the kernel regenerate
+ * the content of a seq_file without reopening it. Short reads are continued until
+ * end of file or until the buffer is full.
+ *
+ * @return Number of bytes read, or -1 on error.
+ */
+ssize_t ProcFile::read()
+{
+    length = 0;
+    buffer[0] = '\0';
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    while (length < capacity)
+    {
+        ssize_t readBytes = pread(fd, buffer.data() + length, capacity - length, static_cast<off_t>(length));
+        if (readBytes < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            length = 0;
+            buffer[0] = '\0';
+            return -1;
+        }
+        if (readBytes == 0)
+        {
+            break;
+        }
+        length += static_cast<size_t>(readBytes);
+    }
+
+    buffer[length] = '\0';
+    return static_cast<ssize_t>(length);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <sys/types.h>
+
+class ProcFile
+{
+public:
+    ProcFile(const std::string &path, size_t capacity = 4096);
+    ~ProcFile();
+
+    ProcFile(const ProcFile &) = delete;
+    ProcFile &operator=(const ProcFile &) = delete;
+
+    // Re-reads the file from offset 0 into the internal buffer
+    ssize_t read();
+
+    bool isOpen() const { return fd >= 0; }
+    const std::string &getPath() const { return path; }
+
+    // Content of the last read, always NUL terminated
+    const char *data() const { return buffer.data(); }
+    size_t size() const { return length; }
+    bool isTruncated() const { return length == capacity; }
+
+private:
+    std::string path;
+    int fd;
+    size_t capacity;
+    size_t length;
+    std::vector<char> buffer;
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Allocation-free cursor over the text of a /proc file.
+ *
+ * All parsing functions advance the cursor and never read past `end`, so the
+ * scanner can be used directly on the buffer of a `ProcFile`.
+ */
+class ProcScanner
+{
+public:
+    ProcScanner(const char *data, size_t size) : pos(data), end(data + size) {}
+
+    bool atEnd() const { return pos >= end; }
+    bool atLineEnd() const { return pos >= end || *pos == '\n'; }
+    const char *position() const { return pos; }
+
+    // Skips spaces and tabs, but not newlines
+    void skipSpaces()
+    {
+        while (pos < end && (*pos == ' ' || *pos == '\t'))
+        {
+            pos++;
+        }
+    }
+
+    // Moves the cursor to the first character of the next line
+    void nextLine()
+    {
+        while (pos < end && *pos != '\n')
+        {
+            pos++;
+        }
+        if (pos < end)
+        {
+            pos++;
+        }
+    }
+
+    // Advances past `prefix` if the cursor starts with it
+    bool match(const char *prefix)
+    {
+        size_t length = std::strlen(prefix);
+        if (static_cast<size_t>(end - pos) < length || std::memcmp(pos, prefix, length) != 0)
+        {
+            return false;
+        }
+        pos += length;
+        return true;
+    }
+
+    // Reads the next run of characters up to a space, tab, newline or `delimiter`
+    bool readToken(const char *&token, size_t &length, char delimiter = '\0')
+    {
+        skipSpaces();
+        token = pos;
+        while (pos < end && *pos != ' ' && *pos != '\t' && *pos != '\n' && *pos != delimiter)
+        {
+            pos++;
+        }
+        length = static_cast<size_t>(pos - token);
+        return length > 0;
+    }
+
+    // Skips one character if it equals `character`
+    bool skip(char character)
+    {
+        if (pos < end && *pos == character)
+        {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    // Reads an unsigned decimal integer, returns false if there is none on the current line
+    bool readUInt(uint64_t &value)
+    {
+        skipSpaces();
+        if (pos >= end || *pos < '0' || *pos > '9')
+        {
+            return false;
+        }
+
+        uint64_t result = 0;
+        while (pos < end && *pos >= '0' && *pos <= '9')
+        {
+            result = result * 10 + static_cast<uint64_t>(*pos - '0');
+            pos++;
+        }
+        value = result;
+        return true;
+    }
+
+    // Reads a signed decimal integer
+    bool readInt(int64_t &value)
+    {
+        skipSpaces();
+        bool negative = skip('-');
+        uint64_t magnitude;
+        if (!readUInt(magnitude))
+        {
+            return false;
+        }
+        value = negative ? -static_cast<int64_t>(magnitude) : static_cast<int64_t>(magnitude);
+        return true;
+    }
+
+    // Reads a fixed-point decimal number such as "12.34"
+    bool readDecimal(double &value)
+    {
+        uint64_t integer;
+        if (!readUInt(integer))
+        {
+            return false;
+        }
+
+        double result = static_cast<double>(integer);
+        if (skip('.'))
+        {
+            double scale = 0.1;
+            while (pos < end && *pos >= '0' && *pos <= '9')
+            {
+                result += (*pos - '0') * scale;
+                scale *= 0.1;
+                pos++;
+            }
+        }
+        value = result;
+        return true;
+    }
+
+private:
+    const char *pos;
+    const char *end;
+};
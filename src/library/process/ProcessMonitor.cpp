@@ -0,0 +1,289 @@
+#include "ProcessMonitor.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <dirent.h>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+
+// Layout of the records returned by getdents64, not exported by glibc before 2.30
+struct LinuxDirent64
+{
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+/**
+ * @brief Opens /proc once and prepares the scan buffers.
+ *
+ * The `/proc` descriptor is kept for the lifetime of the monitor: it is rewound and read
+ * with `getdents64` for every scan, and the per-process files are opened relative to it
+ * with `openat`, so no path is ever resolved from the root.
+ *
+ * @param topCount Number of processes kept in each top list.
+ */
+ProcessMonitor::ProcessMonitor(int topCount)
+    : topCount(topCount > 0 ? topCount : 1), procFd(-1), direntBuffer(32768), scan(0),
+      ticksPerSecond(sysconf(_SC_CLK_TCK)), pageSizeKB(sysconf(_SC_PAGESIZE) / 1024)
+{
+    procFd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (procFd < 0)
+    {
+        throw std::runtime_error("ProcessMonitor: cannot open /proc");
+    }
+
+    cpuHeap.reserve(this->topCount + 1);
+    memoryHeap.reserve(this->topCount + 1);
+}
+
+ProcessMonitor::~ProcessMonitor()
+{
+    close(procFd);
+}
+
+/**
+ * @brief Scans all processes and selects the top ones by CPU and by RSS.
+ *
+ * One scan works as follows:
+ *
+ * 1. **Directory walk**: `/proc` is rewound and read in large chunks with `getdents64`;
+ *    entries whose name is not a number are skipped without any further system call.
+ *
+ * 2. **Per-process read**: `<pid>/stat` and `<pid>/statm` are read with `openat` on the
+ *    cached `/proc` descriptor into stack buffers.
+ *
+ * 3. **CPU delta**: the pid→ticks map holds utime + stime of the previous scan; the CPU
+ *    share is the tick delta over the elapsed time. A changed start time means the pid was
+ *    reused and the process is treated as new. Processes seen for the first time get no
+ *    CPU share in that scan.
+ *
+ * 4. **Selection**: two bounded min-heaps of `process_top_count` entries keep the top
+ *    processes by CPU and by RSS, so selecting costs O(n log N) and never sorts the full list.
+ *
+ * 5. **Eviction**: every record is stamped with the scan number; records with an old stamp
+ *    belong to exited processes and are erased in one pass over the map.
+ *
+ * Processes that exit during the scan simply fail to open and are skipped.
+ */
+void ProcessMonitor::sample()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double elapsedSeconds = scan > 0 ? std::chrono::duration<double>(now - previousScanTime).count() : 0.0;
+    scan++;
+
+    cpuHeap.clear();
+    memoryHeap.clear();
+
+    if (lseek(procFd, 0, SEEK_SET) < 0)
+    {
+        logger.logToConsole("Error rewinding /proc");
+        return;
+    }
+
+    while (true)
+    {
+        long readBytes = syscall(SYS_getdents64, procFd, direntBuffer.data(), direntBuffer.size());
+        if (readBytes < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            logger.logToConsole("Error reading /proc entries");
+            break;
+        }
+        if (readBytes == 0)
+        {
+            break;
+        }
+
+        for (long offset = 0; offset < readBytes;)
+        {
+            const LinuxDirent64 *entry = reinterpret_cast<const LinuxDirent64 *>(direntBuffer.data() + offset);
+            offset += entry->d_reclen;
+
+            if (entry->d_type != DT_DIR || entry->d_name[0] < '1' || entry->d_name[0] > '9')
+            {
+                continue;
+            }
+
+            ProcessStats stats;
+            uint64_t ticks, startTime;
+            if (!readProcess(entry->d_name, stats, ticks, startTime))
+            {
+                continue;
+            }
+
+            ProcessRecord &record = records[stats.pid];
+            bool known = record.scan == scan - 1 && record.startTime == startTime;
+            stats.cpuPercent = (known && elapsedSeconds > 0 && ticks >= record.ticks)
+                                   ? 100.0 * (ticks - record.ticks) / (elapsedSeconds * ticksPerSecond)
+                                   : 0.0;
+            record.ticks = ticks;
+            record.startTime = startTime;
+            record.scan = scan;
+
+            offer(cpuHeap, stats, true);
+            offer(memoryHeap, stats, false);
+        }
+    }
+
+    // evict processes that were not seen in this scan
+    for (auto it = records.begin(); it != records.end();)
+    {
+        it = it->second.scan != scan ? records.erase(it) : std::next(it);
+    }
+
+    std::sort_heap(cpuHeap.begin(), cpuHeap.end(), [](const ProcessStats &a, const ProcessStats &b)
+                   { return a.cpuPercent > b.cpuPercent; });
+    std::sort_heap(memoryHeap.begin(), memoryHeap.end(), [](const ProcessStats &a, const ProcessStats &b)
+                   { return a.rssKB > b.rssKB; });
+
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        topByCpu = cpuHeap;
+        topByMemory = memoryHeap;
+    }
+
+    previousScanTime = now;
+}
+
+std::vector<ProcessStats> ProcessMonitor::getTopByCpu() const
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return topByCpu;
+}
+
+std::vector<ProcessStats> ProcessMonitor::getTopByMemory() const
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return topByMemory;
+}
+
+static ssize_t readAt(int dirFd, const char *path, char *buffer, size_t capacity)
+{
+    int fd = openat(dirFd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    ssize_t length = read(fd, buffer, capacity - 1);
+    close(fd);
+    if (length < 0)
+    {
+        return -1;
+    }
+
+    buffer[length] = '\0';
+    return length;
+}
+
+/**
+ * @brief Reads name, CPU ticks, start time and RSS of one process.
+ *
+ * `stat` is "pid (comm) state ppid ...", where comm may itself contain spaces and
+ * parentheses, so the fields are counted from the last ')'. utime and stime are fields
+ * 14 and 15 and starttime is field 22. The second field of `statm` is the RSS in pages.
+ *
+ * @return False if the process exited or the files could not be parsed.
+ */
+bool ProcessMonitor::readProcess(const char *pid, ProcessStats &stats, uint64_t &ticks, uint64_t &startTime)
+{
+    char path[32];
+    char buffer[1024];
+
+    snprintf(path, sizeof(path), "%s/stat", pid);
+    if (readAt(procFd, path, buffer, sizeof(buffer)) <= 0)
+    {
+        return false;
+    }
+
+    char *nameStart = std::strchr(buffer, '(');
+    char *nameEnd = std::strrchr(buffer, ')');
+    if (nameStart == nullptr || nameEnd == nullptr || nameEnd < nameStart)
+    {
+        return false;
+    }
+
+    stats.pid = std::atoi(buffer);
+    size_t nameLength = std::min(static_cast<size_t>(nameEnd - nameStart - 1), sizeof(stats.name) - 1);
+    std::memcpy(stats.name, nameStart + 1, nameLength);
+    stats.name[nameLength] = '\0';
+
+    // field 3 (state) starts after ") "
+    char *cursor = nameEnd + 2;
+    uint64_t utime = 0, stime = 0;
+    startTime = 0;
+    for (int field = 3; field <= 22 && *cursor != '\0'; field++)
+    {
+        char *next;
+        uint64_t value = std::strtoull(cursor, &next, 10);
+        if (field == 14)
+        {
+            utime = value;
+        }
+        else if (field == 15)
+        {
+            stime = value;
+        }
+        else if (field == 22)
+        {
+            startTime = value;
+        }
+
+        cursor = std::strchr(cursor, ' ');
+        if (cursor == nullptr)
+        {
+            return false;
+        }
+        cursor++;
+    }
+    ticks = utime + stime;
+
+    snprintf(path, sizeof(path), "%s/statm", pid);
+    if (readAt(procFd, path, buffer, sizeof(buffer)) <= 0)
+    {
+        return false;
+    }
+
+    char *resident = std::strchr(buffer, ' ');
+    stats.rssKB = resident != nullptr ? std::strtoull(resident + 1, nullptr, 10) * pageSizeKB : 0;
+    return true;
+}
+
+/**
+ * @brief Offers a process to a bounded min-heap of `topCount` entries.
+ *
+ * The smallest of the current top entries sits at the front, so a process that does not
+ * beat it is rejected with a single comparison.
+ */
+void ProcessMonitor::offer(std::vector<ProcessStats> &heap, const ProcessStats &stats, bool byCpu)
+{
+    auto greater = [byCpu](const ProcessStats &a, const ProcessStats &b)
+    {
+        return byCpu ? a.cpuPercent > b.cpuPercent : a.rssKB > b.rssKB;
+    };
+
+    if (heap.size() < topCount)
+    {
+        heap.push_back(stats);
+        std::push_heap(heap.begin(), heap.end(), greater);
+        return;
+    }
+
+    if (!greater(stats, heap.front()))
+    {
+        return;
+    }
+
+    std::pop_heap(heap.begin(), heap.end(), greater);
+    heap.back() = stats;
+    std::push_heap(heap.begin(), heap.end(), greater);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include "log/Log.hpp"
+
+// CPU and memory usage of one process in the last scan
+struct ProcessStats
+{
+    int pid;
+    char name[16];
+
+    // Share of one CPU since the previous scan, in percent (like top, may exceed 100)
+    double cpuPercent;
+
+    // Resident set size in kB
+    uint64_t rssKB;
+};
+
+class ProcessMonitor
+{
+public:
+    explicit ProcessMonitor(int topCount);
+    ~ProcessMonitor();
+
+    ProcessMonitor(const ProcessMonitor &) = delete;
+    ProcessMonitor &operator=(const ProcessMonitor &) = delete;
+
+    // Scans /proc and selects the top processes, called periodically by the scheduler
+    void sample();
+
+    // Gets the busiest processes of the last scan, highest first
+    std::vector<ProcessStats> getTopByCpu() const;
+
+    // Gets the processes with the largest RSS of the last scan, highest first
+    std::vector<ProcessStats> getTopByMemory() const;
+
+private:
+    struct ProcessRecord
+    {
+        uint64_t ticks;     // utime + stime at the previous scan
+        uint64_t startTime; // detects reuse of the pid by a new process
+        uint32_t scan;      // last scan that saw the process
+    };
+
+    bool readProcess(const char *pid, ProcessStats &stats, uint64_t &ticks, uint64_t &startTime);
+    void offer(std::vector<ProcessStats> &heap, const ProcessStats &stats, bool byCpu);
+
+    size_t topCount;
+    int procFd;
+    std::vector<char> direntBuffer;
+    std::unordered_map<int, ProcessRecord> records;
+    uint32_t scan;
+    long ticksPerSecond;
+    long pageSizeKB;
+    std::chrono::steady_clock::time_point previousScanTime;
+    std::vector<ProcessStats> cpuHeap;
+    std::vector<ProcessStats> memoryHeap;
+    std::vector<ProcessStats> topByCpu;
+    std::vector<ProcessStats> topByMemory;
+    mutable std::mutex statsMutex;
+    Log logger;
+};
@@ -0,0 +1,83 @@
+#include "SampleEvents.hpp"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <time.h>
+#include <stdexcept>
+
+SampleEvents::SampleEvents() : eventFd(-1), pending(0)
+{
+    eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventFd < 0)
+    {
+        throw std::runtime_error("SampleEvents: eventfd failed");
+    }
+    for (int source = 0; source < SAMPLE_SOURCE_COUNT; source++)
+    {
+        sampleNS[source] = 0;
+    }
+}
+
+SampleEvents::~SampleEvents()
+{
+    close(eventFd);
+}
+
+int64_t SampleEvents::nowNS()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Publishes a new sample of a collector.
+ *
+ * Sets the bit of the source in the pending mask. Only the first sample of a source since
+ * the last `consume` records its time, which is where the latency of the evaluation is
+ * measured from, and only the first pending source of a batch writes the eventfd.
+ *
+ * @param source Collector that took the sample.
+ */
+void SampleEvents::publish(SampleSource source)
+{
+    uint32_t bit = sampleSourceBit(source);
+    if (!(pending.load(std::memory_order_relaxed) & bit))
+    {
+        sampleNS[source].store(nowNS(), std::memory_order_relaxed);
+    }
+
+    if (pending.fetch_or(bit, std::memory_order_release) == 0)
+    {
+        uint64_t one = 1;
+        ssize_t written = write(eventFd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+/**
+ * @brief Takes the pending sources.
+ *
+ * Drains the eventfd and clears the pending mask, so the next `publish` signals again.
+ *
+ * @param oldestNS Set to the time of the oldest pending sample, 0 if none is pending.
+ * @return Mask of `sampleSourceBit` of the sources with new samples.
+ */
+uint32_t SampleEvents::consume(int64_t &oldestNS)
+{
+    uint64_t count;
+    ssize_t bytes = read(eventFd, &count, sizeof(count));
+    (void)bytes;
+
+    uint32_t sources = pending.exchange(0, std::memory_order_acquire);
+    oldestNS = 0;
+    for (int source = 0; source < SAMPLE_SOURCE_COUNT; source++)
+    {
+        int64_t timeNS = sampleNS[source].load(std::memory_order_relaxed);
+        if ((sources & sampleSourceBit(static_cast<SampleSource>(source))) && (oldestNS == 0 || timeNS < oldestNS))
+        {
+            oldestNS = timeNS;
+        }
+    }
+    return sources;
+}
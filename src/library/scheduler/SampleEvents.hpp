@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Collectors that publish new samples, one bit each in a source mask
+enum SampleSource
+{
+    SAMPLE_CPU,
+    SAMPLE_MEMORY,
+    SAMPLE_PRESSURE,
+    SAMPLE_DISK,
+    SAMPLE_NET,
+    SAMPLE_SOURCE_COUNT
+};
+
+inline uint32_t sampleSourceBit(SampleSource source) { return 1u << source; }
+
+/**
+ * "New sample" events of the collectors, signalled through an eventfd.
+ *
+ * Collectors `publish` after every sample; the consumer watches `getFd` (e.g. with
+ * `Scheduler::watchFd`) and `consume`s the mask of sources with new samples. Sources are
+ * coalesced until consumed, so the eventfd is written once per batch, not once per sample.
+ */
+class SampleEvents
+{
+public:
+    SampleEvents();
+    ~SampleEvents();
+
+    SampleEvents(const SampleEvents &) = delete;
+    SampleEvents &operator=(const SampleEvents &) = delete;
+
+    // Marks a new sample of `source` and wakes the consumer (thread safe)
+    void publish(SampleSource source);
+
+    // Descriptor that becomes readable when samples are pending
+    int getFd() const { return eventFd; }
+
+    // Returns the mask of sources with new samples and the time of the oldest one (CLOCK_MONOTONIC ns)
+    uint32_t consume(int64_t &oldestNS);
+
+    // Current CLOCK_MONOTONIC time in nanoseconds
+    static int64_t nowNS();
+
+private:
+    int eventFd;
+    std::atomic<uint32_t> pending;
+    std::atomic<int64_t> sampleNS[SAMPLE_SOURCE_COUNT]; // first unconsumed sample per source
+};
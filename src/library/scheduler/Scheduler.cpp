@@ -0,0 +1,293 @@
+#include "Scheduler.hpp"
+
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <time.h>
+#include <cerrno>
+#include <stdexcept>
+
+Scheduler::Scheduler() : timerFd(-1), wakeFd(-1), running(false), resetRequested(false), shutdownRequested(false)
+{
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd < 0)
+    {
+        throw std::runtime_error("Scheduler: timerfd_create failed");
+    }
+
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd < 0)
+    {
+        close(timerFd);
+        throw std::runtime_error("Scheduler: eventfd failed");
+    }
+
+    pollFds.push_back(pollfd{timerFd, POLLIN, 0});
+    pollFds.push_back(pollfd{wakeFd, POLLIN, 0});
+}
+
+Scheduler::~Scheduler()
+{
+    close(timerFd);
+    close(wakeFd);
+}
+
+/**
+ * @brief Registers a task that is executed periodically by the scheduling loop.
+ *
+ * Every task owns its own period. The scheduler keeps one deadline per task in a
+ * min-heap and always sleeps until the earliest one, so collectors with different
+ * check durations share a single thread without waking it more often than needed.
+ *
+ * Tasks must be registered before `run()` is called; the task list is not guarded
+ * against concurrent modification.
+ *
+ * @param name Task name, used in log messages.
+ * @param periodMS Period between two executions in milliseconds (values below 1 are clamped to 1).
+ * @param callback Function executed on the scheduler thread.
+ * @return The id of the registered task.
+ */
+int Scheduler::addTask(const std::string &name, int periodMS, std::function<void()> callback)
+{
+    if (periodMS < 1)
+    {
+        periodMS = 1;
+    }
+
+    Task task;
+    task.name = name;
+    task.periodNS = static_cast<int64_t>(periodMS) * 1000000LL;
+    task.callback = std::move(callback);
+    tasks.push_back(std::move(task));
+
+    resetRequested = true;
+    return static_cast<int>(tasks.size()) - 1;
+}
+
+/**
+ * @brief Watches a file descriptor from the scheduling loop.
+ *
+ * The descriptor is polled together with the timer while the scheduler is running, so
+ * kernel-driven events (for example PSI triggers signalling `POLLPRI`) are handled on the
+ * scheduler thread without a dedicated thread and without periodic polling. While the
+ * scheduler is paused the descriptor is not polled and its events are ignored.
+ *
+ * Descriptors must be registered before `run()` is called and stay owned by the caller.
+ *
+ * @param name Watch name, used in log messages.
+ * @param fd Descriptor to poll.
+ * @param events Poll events to wait for (`POLLIN`, `POLLPRI`, ...).
+ * @param callback Function executed on the scheduler thread with the returned events.
+ */
+void Scheduler::watchFd(const std::string &name, int fd, short events, std::function<void(short)> callback)
+{
+    Watch watch;
+    watch.name = name;
+    watch.callback = std::move(callback);
+    watches.push_back(std::move(watch));
+    pollFds.push_back(pollfd{fd, events, 0});
+}
+
+/**
+ * @brief Runs the scheduling loop on the calling thread.
+ *
+ * The loop pops the earliest deadline from the heap, runs the task if it is due and
+ * pushes the task's next deadline back. Deadlines are absolute (`TFD_TIMER_ABSTIME`),
+ * so the execution time of a task does not shift the period of the following runs.
+ * If a task overruns so much that its next deadline is already in the past, the
+ * missed runs are skipped instead of being executed back to back.
+ *
+ * While the scheduler is paused the timer is disarmed and the thread blocks on the
+ * wake eventfd only, so a disabled monitor costs no wakeups at all.
+ *
+ * The loop returns once `shutdown()` has been called.
+ */
+void Scheduler::run()
+{
+    while (!shutdownRequested)
+    {
+        if (!running)
+        {
+            waitUntil(-1);
+            continue;
+        }
+
+        if (resetRequested.exchange(false))
+        {
+            resetDeadlines();
+        }
+
+        if (deadlines.empty())
+        {
+            waitUntil(-1);
+            continue;
+        }
+
+        Deadline next = deadlines.top();
+        if (next.timeNS > now())
+        {
+            waitUntil(next.timeNS);
+            continue;
+        }
+
+        deadlines.pop();
+        runTask(next.taskId);
+
+        int64_t followingNS = next.timeNS + tasks[next.taskId].periodNS;
+        int64_t currentNS = now();
+        if (followingNS <= currentNS)
+        {
+            followingNS = currentNS + tasks[next.taskId].periodNS;
+        }
+        deadlines.push(Deadline{followingNS, next.taskId});
+    }
+}
+
+/**
+ * @brief Enables task execution.
+ *
+ * All tasks are rescheduled to run immediately, then continue on their own period.
+ */
+void Scheduler::resume()
+{
+    if (running.exchange(true))
+    {
+        return;
+    }
+
+    resetRequested = true;
+    wake();
+}
+
+/**
+ * @brief Disables task execution until `resume()` is called.
+ */
+void Scheduler::pause()
+{
+    if (!running.exchange(false))
+    {
+        return;
+    }
+
+    wake();
+}
+
+/**
+ * @brief Requests the scheduling loop to return.
+ */
+void Scheduler::shutdown()
+{
+    shutdownRequested = true;
+    wake();
+}
+
+int64_t Scheduler::now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+void Scheduler::wake()
+{
+    uint64_t one = 1;
+    ssize_t written = write(wakeFd, &one, sizeof(one));
+    (void)written;
+}
+
+void Scheduler::resetDeadlines()
+{
+    deadlines = std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>>();
+
+    int64_t currentNS = now();
+    for (size_t i = 0; i < tasks.size(); i++)
+    {
+        deadlines.push(Deadline{currentNS, static_cast<int>(i)});
+    }
+}
+
+/**
+ * @brief Blocks until the given absolute deadline or until the scheduler is woken up.
+ *
+ * @param deadlineNS Absolute CLOCK_MONOTONIC deadline in nanoseconds, or a negative
+ *                   value to wait for a wakeup only.
+ */
+void Scheduler::waitUntil(int64_t deadlineNS)
+{
+    itimerspec spec = {};
+    if (deadlineNS >= 0)
+    {
+        spec.it_value.tv_sec = deadlineNS / 1000000000LL;
+        spec.it_value.tv_nsec = deadlineNS % 1000000000LL;
+    }
+    timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, nullptr);
+
+    // watched descriptors follow the timer and the wake eventfd, they are polled only while running
+    nfds_t count = running ? static_cast<nfds_t>(pollFds.size()) : 2;
+    for (nfds_t i = 0; i < count; i++)
+    {
+        pollFds[i].revents = 0;
+    }
+
+    if (poll(pollFds.data(), count, -1) < 0)
+    {
+        if (errno != EINTR)
+        {
+            logger.logToConsole("Scheduler: poll failed (" + std::to_string(errno) + ")");
+        }
+        return;
+    }
+
+    uint64_t counter;
+    if (pollFds[0].revents & POLLIN)
+    {
+        ssize_t readBytes = read(timerFd, &counter, sizeof(counter));
+        (void)readBytes;
+    }
+    if (pollFds[1].revents & POLLIN)
+    {
+        ssize_t readBytes = read(wakeFd, &counter, sizeof(counter));
+        (void)readBytes;
+    }
+
+    for (nfds_t i = 2; i < count; i++)
+    {
+        if (pollFds[i].revents == 0)
+        {
+            continue;
+        }
+
+        runWatch(static_cast<int>(i - 2), pollFds[i].revents);
+
+        // a broken descriptor would wake the loop forever, stop watching it
+        if (pollFds[i].revents & (POLLERR | POLLHUP | POLLNVAL))
+        {
+            logger.logToConsole("Scheduler: watch '" + watches[i - 2].name + "' closed");
+            pollFds[i].fd = -1;
+        }
+    }
+}
+
+void Scheduler::runTask(int taskId)
+{
+    try
+    {
+        tasks[taskId].callback();
+    }
+    catch (const std::exception &e)
+    {
+        logger.logToConsole("Scheduler: task '" + tasks[taskId].name + "' failed: " + e.what());
+    }
+}
+
+void Scheduler::runWatch(int watchId, short revents)
+{
+    try
+    {
+        watches[watchId].callback(revents);
+    }
+    catch (const std::exception &e)
+    {
+        logger.logToConsole("Scheduler: watch '" + watches[watchId].name + "' failed: " + e.what());
+    }
+}
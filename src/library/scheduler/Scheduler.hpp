@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+#include <poll.h>
+#include "log/Log.hpp"
+
+class Scheduler
+{
+public:
+    Scheduler();
+    ~Scheduler();
+
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+
+    // Registers a periodic task, must be called before run()
+    int addTask(const std::string &name, int periodMS, std::function<void()> callback);
+
+    // Watches a descriptor while running, the callback receives the poll revents; must be called before run()
+    void watchFd(const std::string &name, int fd, short events, std::function<void(short)> callback);
+
+    // Runs the scheduling loop on the calling thread until shutdown()
+    void run();
+
+    // Enables or disables running of the registered tasks (thread safe)
+    void resume();
+    void pause();
+    bool isRunning() const { return running.load(); }
+
+    // Stops the scheduling loop (thread safe)
+    void shutdown();
+
+private:
+    struct Task
+    {
+        std::string name;
+        int64_t periodNS;
+        std::function<void()> callback;
+    };
+
+    struct Watch
+    {
+        std::string name;
+        std::function<void(short)> callback;
+    };
+
+    struct Deadline
+    {
+        int64_t timeNS;
+        int taskId;
+
+        bool operator>(const Deadline &other) const { return timeNS > other.timeNS; }
+    };
+
+    // Current CLOCK_MONOTONIC time in nanoseconds
+    static int64_t now();
+
+    void wake();
+    void resetDeadlines();
+    void waitUntil(int64_t deadlineNS);
+    void runTask(int taskId);
+    void runWatch(int watchId, short revents);
+
+    std::vector<Task> tasks;
+    std::vector<Watch> watches;
+    std::vector<pollfd> pollFds;
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines;
+    int timerFd;
+    int wakeFd;
+    std::atomic<bool> running;
+    std::atomic<bool> resetRequested;
+    std::atomic<bool> shutdownRequested;
+    Log logger;
+};
@@ -20,6 +20,41 @@
  *    - `memoryCheckDuration`: The duration (in milliseconds) for checking memory usage.
  *    - `cpuLimit`: The CPU usage threshold for generating warnings.
  *    - `memoryLimit`: The memory usage threshold for generating warnings.
+ *    - `cpuModeLimits`: Optional per-mode CPU thresholds (`cpu_mode_limits`, e.g. `{"steal": 20}`).
+ *    - `coreLimit`, `coreLimitDuration`: Optional per-core threshold and the number of seconds a
+ *      core has to stay above it before a warning is sent.
+ *    - `coreImbalanceLimit`: Optional threshold for the gap between the hottest core and the average.
+ *    - `usageTopCores`: Number of hottest cores listed by `/usage`.
+ *    - `swapLimit`, `dirtyLimitMB`, `commitLimit`: Optional swap usage, dirty page and
+ *      overcommit (Committed_AS / CommitLimit) thresholds.
+ *    - `pressureLimits`, `pressureTriggers`: Optional PSI "some avg10" thresholds per resource
+ *      (`psi_limits`) and kernel PSI triggers (`psi_triggers`), sampled every `psi_check_duration` ms.
+ *    - `disk*`: Optional block device settings: sampling period, table size, exclude patterns,
+ *      partition filter and the utilization / await thresholds.
+ *    - `net*`: Optional network interface settings: sampling period, table size, exclude
+ *      patterns, per-interface thresholds (`net_limits`) and the length of the `/net` list.
+ *    - `processCheckDuration`, `processTopCount`: Period of the process scan and the number of
+ *      processes listed by `/top` and attached to CPU and memory warnings.
+ *    - `historyCapacity`, `historyMemoryBudgetMB`: Samples kept in memory per metric and the
+ *      upper bound for the memory of all in-memory histories.
+ *    - `historyRetentionHours`, `historyPrecision`: Hours of compressed history kept per metric
+ *      and the number of decimals it keeps.
+ *    - `historyRollups`: Downsampling tiers (`history_rollups`), each with a bucket width and
+ *      a retention; by default 1-minute buckets for 7 days and 1-hour buckets for 90 days.
+ *    - `historyFile`, `historyFileSegmentKB`, `historyFileSegments`: Path and geometry of the
+ *      memory-mapped history file that survives restarts (empty path disables it).
+ *    - `historySketchResolutionSec`, `historySketchRetentionHours`: Window and retention of the
+ *      quantile sketches behind `/usage percentiles` (0 hours disables them).
+ *    - `alertRules`: Alert rules (`alert_rules`), each with a name, an expression, a severity
+ *      and a message template; evaluated next to the rules built from the limits above. A rule
+ *      may also set a for-duration, a clear expression, a reminder interval and a resolved message.
+ *    - `alertRenotifySec`, `alertClearMargin`: Default interval between reminders of a firing
+ *      alert (0 sends none) and the margin below a limit at which a limit alert resolves.
+ *    - `telegramQueueCapacity`, `telegramMaxRetries`: Size of the outbound Telegram queue and
+ *      retries of a failed request before it is given up.
+ *    - `telegramChatMessagesPerMinute`, `telegramMessagesPerSecond`: Send rate per chat and for
+ *      the whole bot (Telegram allows about 1 per second per chat and 30 per second).
+ *    - `dashboardIntervalSec`: Refresh interval of the `/dashboard` message.
  *
  * 4. **Return Value**: Returns `true` if the settings were successfully loaded and parsed.
  *    Otherwise, it returns `false` if there was an error opening the file.
@@ -62,6 +97,132 @@ bool Settings::getSetting()
     memoryLimit = (int)settings["memory_limit"];
     defaultMonitoringStatus = (bool)settings["default_monitoring_status"];
 
+    // optional per-core settings
+    coreLimit = settings.value("core_limit", 0);
+    coreLimitDuration = settings.value("core_limit_duration", 30);
+    coreImbalanceLimit = settings.value("core_imbalance_limit", 0);
+    usageTopCores = settings.value("usage_top_cores", 5);
+
+    // optional memory settings
+    swapLimit = settings.value("swap_limit", 0);
+    dirtyLimitMB = settings.value("dirty_limit_mb", 0);
+    commitLimit = settings.value("commit_limit", 0);
+
+    // optional pressure stall information settings
+    pressureCheckDuration = settings.value("psi_check_duration", 2000);
+    if (settings.contains("psi_limits") && settings["psi_limits"].is_object())
+    {
+        for (const auto &limit : settings["psi_limits"].items())
+        {
+            pressureLimits[limit.key()] = (int)limit.value();
+        }
+    }
+    if (settings.contains("psi_triggers") && settings["psi_triggers"].is_array())
+    {
+        for (const auto &trigger_json : settings["psi_triggers"])
+        {
+            PressureTriggerStructure trigger;
+            trigger.resource = trigger_json["resource"];
+            trigger.type = trigger_json.value("type", "some");
+            trigger.stallUS = trigger_json.value("stall_us", 150000);
+            trigger.windowUS = trigger_json.value("window_us", 1000000);
+            pressureTriggers.push_back(trigger);
+        }
+    }
+
+    // optional disk settings
+    diskCheckDuration = settings.value("disk_check_duration", 1000);
+    diskCapacity = settings.value("disk_capacity", 64);
+    if (settings.contains("disk_exclude") && settings["disk_exclude"].is_array())
+    {
+        diskExclude = settings["disk_exclude"].get<std::vector<std::string>>();
+    }
+    diskIncludePartitions = settings.value("disk_include_partitions", false);
+    diskUtilLimit = settings.value("disk_util_limit", 0);
+    diskAwaitLimitMS = settings.value("disk_await_limit_ms", 0);
+
+    // optional network settings
+    netCheckDuration = settings.value("net_check_duration", 1000);
+    netCapacity = settings.value("net_capacity", 512);
+    if (settings.contains("net_exclude") && settings["net_exclude"].is_array())
+    {
+        netExclude = settings["net_exclude"].get<std::vector<std::string>>();
+    }
+    if (settings.contains("net_limits") && settings["net_limits"].is_array())
+    {
+        for (const auto &limit_json : settings["net_limits"])
+        {
+            NetLimitStructure limit;
+            limit.interface = limit_json.value("interface", "*");
+            limit.rxMbps = limit_json.value("rx_mbps", 0);
+            limit.txMbps = limit_json.value("tx_mbps", 0);
+            limit.errorsPerSec = limit_json.value("errors_per_sec", 0);
+            limit.dropsPerSec = limit_json.value("drops_per_sec", 0);
+            netLimits.push_back(limit);
+        }
+    }
+    netTopInterfaces = settings.value("net_top_interfaces", 10);
+
+    // optional process scanner settings
+    processCheckDuration = settings.value("process_check_duration", 5000);
+    processTopCount = settings.value("process_top_count", 5);
+
+    // optional history settings
+    historyCapacity = settings.value("history_capacity", 7200);
+    historyMemoryBudgetMB = settings.value("history_memory_budget_mb", 32);
+    historyRetentionHours = settings.value("history_retention_hours", 24);
+    historyPrecision = settings.value("history_precision", 2);
+    if (settings.contains("history_rollups") && settings["history_rollups"].is_array())
+    {
+        historyRollups.clear();
+        for (const auto &rollup_json : settings["history_rollups"])
+        {
+            RollupTierStructure rollup;
+            rollup.resolutionSec = rollup_json.value("resolution_sec", 60);
+            rollup.retentionHours = rollup_json.value("retention_hours", 24);
+            historyRollups.push_back(rollup);
+        }
+    }
+    historyFile = settings.value("history_file", "history.dat");
+    historyFileSegmentKB = settings.value("history_file_segment_kb", 1024);
+    historyFileSegments = settings.value("history_file_segments", 64);
+    historySketchResolutionSec = settings.value("history_sketch_resolution_sec", 60);
+    historySketchRetentionHours = settings.value("history_sketch_retention_hours", 24);
+
+    // optional alert rules
+    if (settings.contains("alert_rules") && settings["alert_rules"].is_array())
+    {
+        for (const auto &rule_json : settings["alert_rules"])
+        {
+            AlertRuleStructure rule;
+            rule.name = rule_json.value("name", "rule");
+            rule.expression = rule_json.value("expression", "");
+            rule.severity = rule_json.value("severity", "warning");
+            rule.message = rule_json.value("message", "");
+            rule.clearExpression = rule_json.value("clear_expression", "");
+            rule.resolvedMessage = rule_json.value("resolved_message", "");
+            rule.forSeconds = rule_json.value("for_sec", 0);
+            rule.renotifySeconds = rule_json.value("renotify_sec", -1);
+            alertRules.push_back(rule);
+        }
+    }
+    alertRenotifySec = settings.value("alert_renotify_sec", 1800);
+    alertClearMargin = settings.value("alert_clear_margin", 5);
+    telegramQueueCapacity = settings.value("telegram_queue_capacity", 256);
+    telegramMaxRetries = settings.value("telegram_max_retries", 5);
+    telegramChatMessagesPerMinute = settings.value("telegram_chat_messages_per_minute", 60);
+    telegramMessagesPerSecond = settings.value("telegram_messages_per_second", 30);
+    dashboardIntervalSec = settings.value("dashboard_interval_sec", 10);
+
+    // optional per-mode cpu limits
+    if (settings.contains("cpu_mode_limits") && settings["cpu_mode_limits"].is_object())
+    {
+        for (const auto &limit : settings["cpu_mode_limits"].items())
+        {
+            cpuModeLimits[limit.key()] = (int)limit.value();
+        }
+    }
+
     // parse node_list
     if (settings.contains("node_list") && !settings.is_array())
     {
@@ -115,6 +276,47 @@ bool Settings::createSettingsFile()
     // Use consistent key name here
     settings["version"] = appVersion;
     settings["node_list"] = nlohmann::json::array();
+    settings["cpu_mode_limits"] = {{"iowait", 0}, {"steal", 0}};
+    settings["core_limit"] = 0;
+    settings["core_limit_duration"] = 30;
+    settings["core_imbalance_limit"] = 0;
+    settings["usage_top_cores"] = 5;
+    settings["swap_limit"] = 0;
+    settings["dirty_limit_mb"] = 0;
+    settings["commit_limit"] = 0;
+    settings["psi_check_duration"] = 2000;
+    settings["psi_limits"] = {{"cpu", 0}, {"memory", 0}, {"io", 0}};
+    settings["psi_triggers"] = nlohmann::json::array();
+    settings["disk_check_duration"] = 1000;
+    settings["disk_exclude"] = {"loop*", "ram*", "zram*", "sr*", "fd*"};
+    settings["disk_include_partitions"] = false;
+    settings["disk_util_limit"] = 0;
+    settings["disk_await_limit_ms"] = 0;
+    settings["net_check_duration"] = 1000;
+    settings["net_exclude"] = {"lo"};
+    settings["net_limits"] = nlohmann::json::array();
+    settings["net_top_interfaces"] = 10;
+    settings["process_check_duration"] = 5000;
+    settings["process_top_count"] = 5;
+    settings["history_capacity"] = 7200;
+    settings["history_memory_budget_mb"] = 32;
+    settings["history_retention_hours"] = 24;
+    settings["history_precision"] = 2;
+    settings["history_rollups"] = {{{"resolution_sec", 60}, {"retention_hours", 168}},
+                                   {{"resolution_sec", 3600}, {"retention_hours", 2160}}};
+    settings["history_file"] = "history.dat";
+    settings["history_file_segment_kb"] = 1024;
+    settings["history_file_segments"] = 64;
+    settings["history_sketch_resolution_sec"] = 60;
+    settings["history_sketch_retention_hours"] = 24;
+    settings["alert_rules"] = json::array();
+    settings["alert_renotify_sec"] = 1800;
+    settings["alert_clear_margin"] = 5;
+    settings["telegram_queue_capacity"] = 256;
+    settings["telegram_max_retries"] = 5;
+    settings["telegram_chat_messages_per_minute"] = 60;
+    settings["telegram_messages_per_second"] = 30;
+    settings["dashboard_interval_sec"] = 10;
 
     // Bot token
     while (true)
@@ -2,7 +2,12 @@
 
 #include <iostream>
 #include <fstream>
+#include <map>
 #include <node/NodeStructure.hpp>
+#include <pressure/PressureTriggerStructure.hpp>
+#include <network/NetLimitStructure.hpp>
+#include <history/RollupTierStructure.hpp>
+#include <alert/AlertRuleStructure.hpp>
 #include <nlohmann/json.hpp> // Include the JSON library
 #include <log/Log.hpp>
 
@@ -29,6 +34,48 @@ public:
     int getMemoryLimit() const { return memoryLimit; }
     std::vector<NodeStructure> getNodeList() const { return node_list; }
     bool getDefaultMonitoringStatus() const { return defaultMonitoringStatus; }
+    std::map<std::string, int> getCpuModeLimits() const { return cpuModeLimits; }
+    int getCoreLimit() const { return coreLimit; }
+    int getCoreLimitDuration() const { return coreLimitDuration; }
+    int getCoreImbalanceLimit() const { return coreImbalanceLimit; }
+    int getUsageTopCores() const { return usageTopCores; }
+    int getSwapLimit() const { return swapLimit; }
+    int getDirtyLimitMB() const { return dirtyLimitMB; }
+    int getCommitLimit() const { return commitLimit; }
+    int getPressureCheckDuration() const { return pressureCheckDuration; }
+    std::map<std::string, int> getPressureLimits() const { return pressureLimits; }
+    std::vector<PressureTriggerStructure> getPressureTriggers() const { return pressureTriggers; }
+    int getDiskCheckDuration() const { return diskCheckDuration; }
+    int getDiskCapacity() const { return diskCapacity; }
+    std::vector<std::string> getDiskExclude() const { return diskExclude; }
+    bool getDiskIncludePartitions() const { return diskIncludePartitions; }
+    int getDiskUtilLimit() const { return diskUtilLimit; }
+    int getDiskAwaitLimitMS() const { return diskAwaitLimitMS; }
+    int getNetCheckDuration() const { return netCheckDuration; }
+    int getNetCapacity() const { return netCapacity; }
+    std::vector<std::string> getNetExclude() const { return netExclude; }
+    std::vector<NetLimitStructure> getNetLimits() const { return netLimits; }
+    int getNetTopInterfaces() const { return netTopInterfaces; }
+    int getProcessCheckDuration() const { return processCheckDuration; }
+    int getProcessTopCount() const { return processTopCount; }
+    int getHistoryCapacity() const { return historyCapacity; }
+    int getHistoryMemoryBudgetMB() const { return historyMemoryBudgetMB; }
+    int getHistoryRetentionHours() const { return historyRetentionHours; }
+    int getHistoryPrecision() const { return historyPrecision; }
+    std::vector<RollupTierStructure> getHistoryRollups() const { return historyRollups; }
+    std::string getHistoryFile() const { return historyFile; }
+    int getHistoryFileSegmentKB() const { return historyFileSegmentKB; }
+    int getHistoryFileSegments() const { return historyFileSegments; }
+    int getHistorySketchResolutionSec() const { return historySketchResolutionSec; }
+    int getHistorySketchRetentionHours() const { return historySketchRetentionHours; }
+    std::vector<AlertRuleStructure> getAlertRules() const { return alertRules; }
+    int getAlertRenotifySec() const { return alertRenotifySec; }
+    int getAlertClearMargin() const { return alertClearMargin; }
+    int getTelegramQueueCapacity() const { return telegramQueueCapacity; }
+    int getTelegramMaxRetries() const { return telegramMaxRetries; }
+    int getTelegramChatMessagesPerMinute() const { return telegramChatMessagesPerMinute; }
+    int getTelegramMessagesPerSecond() const { return telegramMessagesPerSecond; }
+    int getDashboardIntervalSec() const { return dashboardIntervalSec; }
 
 private:
     // settings parameters
@@ -41,6 +88,48 @@ private:
     int cpuLimit;
     int memoryLimit;
     bool defaultMonitoringStatus;
+    std::map<std::string, int> cpuModeLimits;
+    int coreLimit = 0;
+    int coreLimitDuration = 30;
+    int coreImbalanceLimit = 0;
+    int usageTopCores = 5;
+    int swapLimit = 0;
+    int dirtyLimitMB = 0;
+    int commitLimit = 0;
+    int pressureCheckDuration = 2000;
+    std::map<std::string, int> pressureLimits;
+    std::vector<PressureTriggerStructure> pressureTriggers;
+    int diskCheckDuration = 1000;
+    int diskCapacity = 64;
+    std::vector<std::string> diskExclude = {"loop*", "ram*", "zram*", "sr*", "fd*"};
+    bool diskIncludePartitions = false;
+    int diskUtilLimit = 0;
+    int diskAwaitLimitMS = 0;
+    int netCheckDuration = 1000;
+    int netCapacity = 512;
+    std::vector<std::string> netExclude = {"lo"};
+    std::vector<NetLimitStructure> netLimits;
+    int netTopInterfaces = 10;
+    int processCheckDuration = 5000;
+    int processTopCount = 5;
+    int historyCapacity = 7200;
+    int historyMemoryBudgetMB = 32;
+    int historyRetentionHours = 24;
+    int historyPrecision = 2;
+    std::vector<RollupTierStructure> historyRollups = {{60, 7 * 24}, {3600, 90 * 24}};
+    std::string historyFile = "history.dat";
+    int historyFileSegmentKB = 1024;
+    int historyFileSegments = 64;
+    int historySketchResolutionSec = 60;
+    int historySketchRetentionHours = 24;
+    std::vector<AlertRuleStructure> alertRules;
+    int alertRenotifySec = 1800;
+    int alertClearMargin = 5;
+    int telegramQueueCapacity = 256;
+    int telegramMaxRetries = 5;
+    int telegramChatMessagesPerMinute = 60;
+    int telegramMessagesPerSecond = 30;
+    int dashboardIntervalSec = 10;
     std::vector<NodeStructure> node_list;
 
     // dependencies
@@ -0,0 +1,313 @@
+#include "OutboundQueue.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+const size_t OutboundQueue::MAX_MESSAGE_LENGTH;
+
+OutboundQueue::OutboundQueue(const TgBot::Api &api, size_t capacity, int maxRetries, double chatRatePerSec, double globalRatePerSec)
+    : api(api), capacity(std::max<size_t>(capacity, 1)), maxRetries(maxRetries), chatRatePerSec(chatRatePerSec),
+      globalBucket(globalRatePerSec, globalRatePerSec), size(0), pushCount(0), pausedUntilNS(0), stopping(false), sent(0), retries(0), dropped(0), failed(0), coalesced(0)
+{
+    senderThread = std::thread(&OutboundQueue::thread_sender, this);
+}
+
+OutboundQueue::~OutboundQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_one();
+    senderThread.join();
+}
+
+bool OutboundQueue::sendMessage(int64_t chatId, const std::string &text, OutboundPriority priority)
+{
+    return push(Item{chatId, text, Request(), 0, 0}, priority);
+}
+
+bool OutboundQueue::sendRequest(int64_t chatId, const std::string &description, Request request, OutboundPriority priority)
+{
+    return push(Item{chatId, description, std::move(request), 0, 0}, priority);
+}
+
+/**
+ * @brief Appends a request to its lane.
+ *
+ * Only takes the queue lock, never waits for the sender. When the queue holds `capacity`
+ * requests, the oldest request of the lowest lane below `priority` is evicted to make room;
+ * if there is none, the new request is rejected. Both count as dropped and are logged.
+ *
+ * @return True if the request was queued.
+ */
+bool OutboundQueue::push(Item item, OutboundPriority priority)
+{
+    std::string droppedText;
+    bool accepted = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (size >= capacity)
+        {
+            int lowest = OUTBOUND_PRIORITY_COUNT - 1;
+            while (lowest > priority && lanes[lowest].empty())
+            {
+                lowest--;
+            }
+
+            if (lowest > priority)
+            {
+                droppedText = lanes[lowest].front().text;
+                lanes[lowest].pop_front();
+                size--;
+            }
+            else
+            {
+                droppedText = item.text;
+                accepted = false;
+            }
+            dropped++;
+        }
+
+        if (accepted)
+        {
+            lanes[priority].push_back(std::move(item));
+            size++;
+            pushCount++;
+        }
+    }
+
+    if (!droppedText.empty())
+    {
+        logger.logToConsole("Outbound queue full, dropped: " + droppedText.substr(0, droppedText.find('\n')));
+    }
+    if (accepted)
+    {
+        wakeup.notify_one();
+    }
+    return accepted;
+}
+
+OutboundStats OutboundQueue::getStats() const
+{
+    OutboundStats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int lane = 0; lane < OUTBOUND_PRIORITY_COUNT; lane++)
+        {
+            stats.depth[lane] = lanes[lane].size();
+        }
+    }
+    stats.sent = sent;
+    stats.retries = retries;
+    stats.dropped = dropped;
+    stats.failed = failed;
+    stats.coalesced = coalesced;
+    return stats;
+}
+
+TokenBucket &OutboundQueue::chatBucket(int64_t chatId)
+{
+    auto found = chatBuckets.find(chatId);
+    if (found == chatBuckets.end())
+    {
+        found = chatBuckets.emplace(chatId, TokenBucket(chatRatePerSec, 1.0)).first;
+    }
+    return found->second;
+}
+
+/**
+ * @brief Merges the other pending alerts of the same chat into an alert.
+ *
+ * Called with the queue locked for a text alert that is about to be sent. Text alerts of
+ * the same chat in the alert lanes are appended, separated by a blank line, as long as the
+ * message stays within `MAX_MESSAGE_LENGTH`; the rest stay queued for the next message. So
+ * an incident that raises CPU, memory and disk alerts at once costs one send.
+ *
+ * @param item Alert taken from the queue, extended in place.
+ */
+void OutboundQueue::coalesce(Item &item)
+{
+    for (int lane = OUTBOUND_CRITICAL; lane < OUTBOUND_REPLY; lane++)
+    {
+        for (auto pending = lanes[lane].begin(); pending != lanes[lane].end();)
+        {
+            if (pending->chatId != item.chatId || pending->request || item.text.size() + 2 + pending->text.size() > MAX_MESSAGE_LENGTH)
+            {
+                ++pending;
+                continue;
+            }
+
+            item.text += "\n\n" + pending->text;
+            pending = lanes[lane].erase(pending);
+            size--;
+            coalesced++;
+        }
+    }
+}
+
+void OutboundQueue::send(const Item &item)
+{
+    if (item.request)
+    {
+        item.request(api);
+    }
+    else
+    {
+        api.sendMessage(item.chatId, item.text);
+    }
+}
+
+int64_t OutboundQueue::steadyNowNS()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int OutboundQueue::retryAfterSeconds(const std::string &error)
+{
+    size_t position = error.find("retry after ");
+    return position == std::string::npos ? 0 : std::max(atoi(error.c_str() + position + 12), 0);
+}
+
+/**
+ * @brief Sends the queued requests, highest lane first.
+ *
+ * Runs on the sender thread until the queue is destroyed. A request that fails is put
+ * back at the head of its lane and retried after a delay, so a failing Telegram API never
+ * delays the producers:
+ *
+ * - "Too Many Requests" errors wait the `retry_after` seconds sent by Telegram and do not
+ *   count as an attempt. Telegram refuses every send meanwhile, so the whole queue pauses.
+ * - Network errors and server errors wait 1, 2, 4, ... seconds (at most 60) and are given
+ *   up after `maxRetries` retries. Only the failed request waits; the thread keeps sending
+ *   the other requests, so e.g. a failing upload in the reply lane does not hold back alerts.
+ * - Requests Telegram refuses (bad request, forbidden, not found) are given up at once.
+ *
+ * Every send takes a token of the global bucket and of its chat. The thread sends the
+ * first request, highest lane first, whose chat has a token, so a throttled chat does not
+ * hold back the others, and sleeps until the next token otherwise. After any wait the
+ * highest lane is picked again, so a critical alert queued meanwhile goes first. No
+ * exception leaves this thread.
+ */
+void OutboundQueue::thread_sender()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        wakeup.wait(lock, [this]()
+                    { return stopping || size > 0; });
+        if (stopping)
+        {
+            return;
+        }
+
+        // first request, highest lane first, whose chat has budget; alerts queued while
+        // waiting are merged
+        int64_t nowNS = steadyNowNS();
+        int64_t globalWaitNS = std::max(globalBucket.waitNS(nowNS), pausedUntilNS - nowNS);
+        int64_t waitNS = globalWaitNS;
+        int lane = -1;
+        std::deque<Item>::iterator next;
+        for (int candidate = 0; candidate < OUTBOUND_PRIORITY_COUNT && globalWaitNS <= 0 && lane < 0; candidate++)
+        {
+            for (next = lanes[candidate].begin(); next != lanes[candidate].end(); ++next)
+            {
+                // a request in backoff waits alone, the requests behind it go first
+                int64_t itemWaitNS = next->retryAtNS - nowNS;
+                if (itemWaitNS <= 0)
+                {
+                    itemWaitNS = chatBucket(next->chatId).waitNS(nowNS);
+                    if (itemWaitNS == 0)
+                    {
+                        lane = candidate;
+                        break;
+                    }
+                }
+                waitNS = waitNS <= 0 ? itemWaitNS : std::min(waitNS, itemWaitNS);
+            }
+        }
+        if (lane < 0)
+        {
+            // a new request may be for a chat with budget
+            uint64_t seen = pushCount;
+            wakeup.wait_for(lock, std::chrono::nanoseconds(waitNS), [this, seen]()
+                            { return stopping || pushCount != seen; });
+            continue;
+        }
+        globalBucket.take();
+        chatBucket(next->chatId).take();
+
+        Item item = std::move(*next);
+        lanes[lane].erase(next);
+        size--;
+        if (lane != OUTBOUND_REPLY && !item.request)
+        {
+            coalesce(item);
+        }
+        lock.unlock();
+
+        int64_t delayMS = 0;
+        bool giveUp = false;
+        bool flooded = false;
+        std::string error;
+        try
+        {
+            send(item);
+            sent++;
+        }
+        catch (TgBot::TgException &e)
+        {
+            error = e.what();
+            int retryAfter = retryAfterSeconds(error);
+            size_t code = static_cast<size_t>(e.errorCode);
+            if (retryAfter > 0)
+            {
+                delayMS = retryAfter * 1000LL;
+                flooded = true;
+            }
+            else
+            {
+                giveUp = code >= 400 && code < 500;
+            }
+        }
+        catch (std::exception &e)
+        {
+            error = e.what();
+        }
+
+        lock.lock();
+        if (error.empty())
+        {
+            continue;
+        }
+
+        if (delayMS == 0)
+        {
+            item.attempts++;
+            delayMS = std::min<int64_t>(1000LL << std::min(item.attempts - 1, 6), 60000);
+            giveUp = giveUp || item.attempts > maxRetries;
+        }
+        if (giveUp)
+        {
+            failed++;
+            lock.unlock();
+            logger.logToConsole("Telegram request failed (" + error + "), given up: " + item.text.substr(0, item.text.find('\n')));
+            lock.lock();
+            continue;
+        }
+
+        retries++;
+        int64_t retryAtNS = steadyNowNS() + delayMS * 1000000LL;
+        if (flooded)
+        {
+            pausedUntilNS = std::max(pausedUntilNS, retryAtNS);
+        }
+        item.retryAtNS = retryAtNS;
+        lanes[lane].push_front(std::move(item));
+        size++;
+        lock.unlock();
+        logger.logToConsole("Telegram request failed (" + error + "), retry in " + std::to_string(delayMS) + " ms");
+        lock.lock();
+    }
+}
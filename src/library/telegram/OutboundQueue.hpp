@@ -0,0 +1,114 @@
+#pragma once
+
+#include <tgbot/tgbot.h>
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+#include "log/Log.hpp"
+#include "telegram/TokenBucket.hpp"
+
+// Lanes of the outbound queue, drained in this order
+enum OutboundPriority
+{
+    OUTBOUND_CRITICAL, // critical alerts
+    OUTBOUND_ALERT,    // other alerts and resolved messages
+    OUTBOUND_REPLY,    // command replies
+    OUTBOUND_PRIORITY_COUNT
+};
+
+// Counters of the outbound queue
+struct OutboundStats
+{
+    size_t depth[OUTBOUND_PRIORITY_COUNT];
+    uint64_t sent;
+    uint64_t retries;
+    uint64_t dropped; // evicted or rejected because the queue was full
+    uint64_t failed;  // given up after an error or too many retries
+    uint64_t coalesced; // alerts merged into an earlier alert of the same chat
+};
+
+/**
+ * Bounded multi-producer queue of Telegram requests with one sender thread.
+ *
+ * Producers (scheduler, bot command handlers) only take a short lock to append a request
+ * and never wait for the network. The sender thread drains the lanes in priority order and
+ * retries failed requests with exponential backoff, waiting `retry_after` seconds when
+ * Telegram asks for it. The queue must be the only retry layer: the bot's HTTP client has
+ * `TgBot::Api`'s own retries disabled (`PooledHttpClient::getRequestMaxRetries`), so a 4xx
+ * error reaches the sender at once and a timed-out request is not posted again behind its back.
+ *
+ * Sends are paced by token buckets, one per chat and one for the bot, so bursts stay
+ * within Telegram's limits. Alerts for the same chat that pile up while the budget is
+ * exhausted are merged into one message.
+ */
+class OutboundQueue
+{
+public:
+    // Custom request such as sendPhoto or sendDocument
+    typedef std::function<void(const TgBot::Api &)> Request;
+
+    // Telegram's limit for the text of one message
+    static const size_t MAX_MESSAGE_LENGTH = 4096;
+
+    OutboundQueue(const TgBot::Api &api, size_t capacity, int maxRetries, double chatRatePerSec, double globalRatePerSec);
+    ~OutboundQueue();
+
+    OutboundQueue(const OutboundQueue &) = delete;
+    OutboundQueue &operator=(const OutboundQueue &) = delete;
+
+    // Queues a text message, returns false (counted as dropped) if the queue is full of higher priorities
+    bool sendMessage(int64_t chatId, const std::string &text, OutboundPriority priority = OUTBOUND_REPLY);
+
+    // Queues a custom request; `description` is used in log messages
+    bool sendRequest(int64_t chatId, const std::string &description, Request request, OutboundPriority priority = OUTBOUND_REPLY);
+
+    OutboundStats getStats() const;
+
+private:
+    struct Item
+    {
+        int64_t chatId;
+        std::string text; // message text, or the description of a custom request
+        Request request;  // empty for a text message
+        int attempts;
+        int64_t retryAtNS; // steady clock time before which a failed request is not sent again
+    };
+
+    bool push(Item item, OutboundPriority priority);
+    void thread_sender();
+    void send(const Item &item);
+    void coalesce(Item &item);
+    TokenBucket &chatBucket(int64_t chatId);
+
+    static int64_t steadyNowNS();
+
+    // Seconds of a "retry after N" error, 0 if the error has none
+    static int retryAfterSeconds(const std::string &error);
+
+    const TgBot::Api &api;
+    size_t capacity;
+    int maxRetries;
+    double chatRatePerSec;
+    TokenBucket globalBucket;
+    std::unordered_map<int64_t, TokenBucket> chatBuckets;
+    std::deque<Item> lanes[OUTBOUND_PRIORITY_COUNT];
+    size_t size;
+    uint64_t pushCount;
+    int64_t pausedUntilNS; // end of the last `retry_after` wait, nothing is sent before it
+    mutable std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopping;
+    std::atomic<uint64_t> sent;
+    std::atomic<uint64_t> retries;
+    std::atomic<uint64_t> dropped;
+    std::atomic<uint64_t> failed;
+    std::atomic<uint64_t> coalesced;
+    Log logger;
+    std::thread senderThread;
+};
@@ -0,0 +1,195 @@
+#include "PooledHttpClient.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+// Uploads slower than this many bytes per second for this many seconds are aborted
+static const long UPLOAD_LOW_SPEED_BYTES = 1024;
+static const long UPLOAD_LOW_SPEED_SEC = 30;
+
+PooledHttpClient::PooledHttpClient(ConnectionMode mode, size_t maxIdleHandles, const std::string &caFile)
+    : mode(mode), maxIdleHandles(maxIdleHandles), caFile(caFile), share(nullptr), requests(0), connections(0)
+{
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    share = curl_share_init();
+    if (!share)
+    {
+        throw std::runtime_error("PooledHttpClient: curl_share_init failed");
+    }
+    curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lockShare);
+    curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlockShare);
+    curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    if (mode != FRESH)
+    {
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+}
+
+PooledHttpClient::~PooledHttpClient()
+{
+    for (CURL *handle : idleHandles)
+    {
+        curl_easy_cleanup(handle);
+    }
+    curl_share_cleanup(share);
+    curl_global_cleanup();
+}
+
+void PooledHttpClient::lockShare(CURL *, curl_lock_data data, curl_lock_access, void *client)
+{
+    static_cast<PooledHttpClient *>(client)->shareLocks[data].lock();
+}
+
+void PooledHttpClient::unlockShare(CURL *, curl_lock_data data, void *client)
+{
+    static_cast<PooledHttpClient *>(client)->shareLocks[data].unlock();
+}
+
+size_t PooledHttpClient::appendBody(char *data, size_t size, size_t count, void *body)
+{
+    static_cast<std::string *>(body)->append(data, size * count);
+    return size * count;
+}
+
+CURL *PooledHttpClient::acquire() const
+{
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (!idleHandles.empty())
+        {
+            CURL *handle = idleHandles.back();
+            idleHandles.pop_back();
+            return handle;
+        }
+    }
+
+    CURL *handle = curl_easy_init();
+    if (!handle)
+    {
+        throw std::runtime_error("PooledHttpClient: curl_easy_init failed");
+    }
+    return handle;
+}
+
+void PooledHttpClient::release(CURL *handle) const
+{
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (idleHandles.size() < maxIdleHandles)
+        {
+            idleHandles.push_back(handle);
+            return;
+        }
+    }
+    curl_easy_cleanup(handle);
+}
+
+/**
+ * @brief Executes one Bot API request.
+ *
+ * Takes an idle handle from the pool (or creates one), so concurrent calls from the bot,
+ * sender and scheduler threads each use their own handle. A handle keeps its live
+ * connection across `curl_easy_reset`, so the next call on it reuses that connection;
+ * only the TLS session and DNS caches are shared between handles (libcurl does not support
+ * sharing connections between concurrent threads). Requests without arguments are GETs, requests with files are
+ * sent as multipart form data and all others as URL-encoded forms, like the tgbot clients.
+ * Requests time out after `_timeout` seconds, except uploads (photos, exports), which have
+ * no total limit and are only aborted when they stall.
+ *
+ * @param url Bot API method URL.
+ * @param args Method arguments.
+ * @return The response body; HTTP errors return Telegram's JSON error, which `TgBot::Api`
+ *         turns into a `TgException`.
+ * @throws std::runtime_error on transport errors (connect, TLS, timeout).
+ */
+std::string PooledHttpClient::makeRequest(const TgBot::Url &url, const std::vector<TgBot::HttpReqArg> &args) const
+{
+    CURL *handle = acquire();
+    curl_easy_reset(handle);
+
+    std::string address = url.protocol + "://" + url.host + url.path;
+    if (args.empty() && !url.query.empty())
+    {
+        address += "?" + url.query;
+    }
+    curl_easy_setopt(handle, CURLOPT_URL, address.c_str());
+    curl_easy_setopt(handle, CURLOPT_SHARE, share);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, 10L);
+    if (mode != KEEP_ALIVE)
+    {
+        curl_easy_setopt(handle, CURLOPT_FRESH_CONNECT, 1L);
+        curl_easy_setopt(handle, CURLOPT_FORBID_REUSE, 1L);
+    }
+    if (mode == FRESH)
+    {
+        curl_easy_setopt(handle, CURLOPT_SSL_SESSIONID_CACHE, 0L);
+    }
+    if (!caFile.empty())
+    {
+        curl_easy_setopt(handle, CURLOPT_CAINFO, caFile.c_str());
+    }
+
+    std::string body;
+    curl_mime *form = nullptr;
+    bool hasFile = std::any_of(args.begin(), args.end(), [](const TgBot::HttpReqArg &arg)
+                               { return arg.isFile; });
+    if (hasFile)
+    {
+        form = curl_mime_init(handle);
+        for (const TgBot::HttpReqArg &arg : args)
+        {
+            curl_mimepart *part = curl_mime_addpart(form);
+            curl_mime_name(part, arg.name.c_str());
+            curl_mime_data(part, arg.value.data(), arg.value.size());
+            if (arg.isFile)
+            {
+                curl_mime_filename(part, arg.fileName.c_str());
+                curl_mime_type(part, arg.mimeType.c_str());
+            }
+        }
+        curl_easy_setopt(handle, CURLOPT_MIMEPOST, form);
+
+        // an upload of up to 50 MB takes as long as the uplink needs; only a stalled one is aborted
+        curl_easy_setopt(handle, CURLOPT_LOW_SPEED_LIMIT, UPLOAD_LOW_SPEED_BYTES);
+        curl_easy_setopt(handle, CURLOPT_LOW_SPEED_TIME, UPLOAD_LOW_SPEED_SEC);
+    }
+    else if (!args.empty())
+    {
+        body = parser.generateWwwFormUrlencoded(args);
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDS, body.c_str());
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, static_cast<long>(body.size()));
+    }
+    if (!hasFile)
+    {
+        curl_easy_setopt(handle, CURLOPT_TIMEOUT, static_cast<long>(_timeout));
+    }
+
+    std::string response;
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, appendBody);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &response);
+
+    CURLcode result = curl_easy_perform(handle);
+    long connects = 0;
+    long status = 0;
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &status);
+    requests++;
+    connections += static_cast<uint64_t>(connects);
+
+    curl_mime_free(form);
+    release(handle);
+
+    if (result != CURLE_OK)
+    {
+        throw std::runtime_error(std::string("curl error: ") + curl_easy_strerror(result));
+    }
+    if (response.empty())
+    {
+        throw std::runtime_error("empty response, HTTP status " + std::to_string(status));
+    }
+    return response;
+}
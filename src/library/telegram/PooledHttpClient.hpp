@@ -0,0 +1,65 @@
+#pragma once
+
+#include <tgbot/net/HttpClient.h>
+#include <tgbot/net/HttpParser.h>
+#include <curl/curl.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Bot API client that keeps its HTTPS connections alive.
+ *
+ * The default tgbot client opens a new TCP connection and does a full TLS handshake for
+ * every call. This client keeps a pool of libcurl handles, each with its own keep-alive
+ * connection, so a call from any thread takes an idle handle and reuses its connection.
+ * The handles share one TLS session cache and one DNS cache, so a new connection resumes
+ * an earlier TLS session.
+ */
+class PooledHttpClient : public TgBot::HttpClient
+{
+public:
+    enum ConnectionMode
+    {
+        KEEP_ALIVE,  // reuse each pooled handle's connection, resume TLS sessions
+        RESUME_ONLY, // new connection per request, resumed TLS session
+        FRESH        // new connection and full TLS handshake per request (like the default client)
+    };
+
+    // `caFile` replaces the system CA bundle (e.g. for a local test server)
+    explicit PooledHttpClient(ConnectionMode mode = KEEP_ALIVE, size_t maxIdleHandles = 4, const std::string &caFile = "");
+    ~PooledHttpClient() override;
+
+    PooledHttpClient(const PooledHttpClient &) = delete;
+    PooledHttpClient &operator=(const PooledHttpClient &) = delete;
+
+    std::string makeRequest(const TgBot::Url &url, const std::vector<TgBot::HttpReqArg> &args) const override;
+
+    // `TgBot::Api` would otherwise repeat every failed call 3 times, 1 s apart, before the
+    // caller sees the error; `OutboundQueue` does its own backoff and `retry_after` handling
+    int getRequestMaxRetries() const override { return 0; }
+
+    uint64_t getRequestCount() const { return requests; }
+    uint64_t getConnectionCount() const { return connections; }
+
+private:
+    CURL *acquire() const;
+    void release(CURL *handle) const;
+
+    static void lockShare(CURL *handle, curl_lock_data data, curl_lock_access access, void *client);
+    static void unlockShare(CURL *handle, curl_lock_data data, void *client);
+    static size_t appendBody(char *data, size_t size, size_t count, void *body);
+
+    ConnectionMode mode;
+    size_t maxIdleHandles;
+    std::string caFile;
+    CURLSH *share;
+    std::mutex shareLocks[CURL_LOCK_DATA_LAST];
+    mutable std::mutex poolMutex;
+    mutable std::vector<CURL *> idleHandles;
+    mutable std::atomic<uint64_t> requests;
+    mutable std::atomic<uint64_t> connections; // new connections, the rest were reused
+    TgBot::HttpParser parser;
+};
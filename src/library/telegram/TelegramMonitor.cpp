@@ -1,8 +1,185 @@
 #include "TelegramMonitor.hpp"
 
-TelegramMonitor::TelegramMonitor(bool &isMonitoringEnable, CpuMonitor &cpu, MemoryMonitor &memory, const Settings settings, Log logger)
-    : isMonitoringEnable(isMonitoringEnable), cpu(cpu), memory(memory), settings(settings), logger(logger), tgNotificationStatus(false), bot(settings.getBotToken())
+#include <algorithm>
+#include <sstream>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// Pause before polling again after a transport error
+static const unsigned LONG_POLL_RETRY_SEC = 5;
+
+// Largest file a bot may upload with the Bot API
+static const long long MAX_UPLOAD_BYTES = 50LL * 1024 * 1024;
+
+TelegramMonitor::TelegramMonitor(Scheduler &scheduler, CpuMonitor &cpu, MemoryMonitor &memory, PressureMonitor &pressure, DiskMonitor &disk, NetMonitor &net, ProcessMonitor &processes, MetricStore &metrics, const Settings settings, Log logger)
+    : logger(logger), settings(settings), cpu(cpu), memory(memory), pressure(pressure), disk(disk), net(net), processes(processes), metrics(metrics), chartRenderer(480, 200), alerts(metrics),
+      alertVariables(alerts, cpu, memory, pressure, disk, net), scheduler(scheduler), bot(settings.getBotToken(), httpClient),
+      dashboardMessageId(0), dashboardGeneration(0), dashboardShownId(0), dashboardHash(0),
+      dashboardEditQueued(false), dashboardPendingId(0), dashboardPendingHash(0), outbound(bot.getApi(), settings.getTelegramQueueCapacity(), settings.getTelegramMaxRetries(),
+               settings.getTelegramChatMessagesPerMinute() / 60.0, settings.getTelegramMessagesPerSecond())
+{
+    // resolve per-mode cpu limits once
+    for (int mode = 0; mode < CPU_MODE_COUNT; mode++)
+    {
+        cpuModeLimits[mode] = 0;
+    }
+    for (const auto &limit : settings.getCpuModeLimits())
+    {
+        int mode = cpuModeFromName(limit.first.c_str());
+        if (mode < 0)
+        {
+            logger.logToConsole("Unknown cpu mode in cpu_mode_limits: " + limit.first);
+            continue;
+        }
+        cpuModeLimits[mode] = limit.second;
+    }
+
+    // resolve pressure limits once
+    for (int resource = 0; resource < PRESSURE_RESOURCE_COUNT; resource++)
+    {
+        pressureLimits[resource] = 0;
+    }
+    for (const auto &limit : settings.getPressureLimits())
+    {
+        int resource = PressureMonitor::resourceFromName(limit.first);
+        if (resource < 0)
+        {
+            logger.logToConsole("Unknown resource in psi_limits: " + limit.first);
+            continue;
+        }
+        pressureLimits[resource] = limit.second;
+    }
+
+    // alert rules: the limits above first, then the rules of alert_rules
+    alerts.addText("top_cpu", [this]()
+                   { return formatTopProcesses(true); });
+    alerts.addText("top_memory", [this]()
+                   { return formatTopProcesses(false); });
+    addLimitRules();
+    for (AlertRuleStructure rule : settings.getAlertRules())
+    {
+        if (rule.renotifySeconds < 0)
+        {
+            rule.renotifySeconds = settings.getAlertRenotifySec();
+        }
+        alerts.addRule(rule);
+    }
+    logger.logToConsole(std::to_string(alerts.getRuleCount()) + " alert rules loaded");
+}
+
+/**
+ * @brief Turns the scalar limits of the settings into alert rules.
+ *
+ * `cpu_limit`, `cpu_mode_limits`, `core_limit`, `core_imbalance_limit`, `memory_limit`,
+ * `psi_limits`, `swap_limit`, `dirty_limit_mb` and `commit_limit` become rules with the
+ * same condition and message as the former hard-coded checks; a limit of 0 adds no rule.
+ * A limit alert resolves once its value drops `alert_clear_margin` percent below the limit
+ * (e.g. 85.5% for a CPU limit of 90%), so a value hovering around the limit does not fire
+ * again and again.
+ */
+void TelegramMonitor::addLimitRules()
+{
+    auto addLimit = [this](const std::string &name, const std::string &expression, const std::string &clearExpression,
+                           const std::string &message, const std::string &resolvedMessage)
+    {
+        AlertRuleStructure rule;
+        rule.name = name;
+        rule.expression = expression;
+        rule.severity = "warning";
+        rule.message = message;
+        rule.clearExpression = clearExpression;
+        rule.resolvedMessage = resolvedMessage;
+        rule.forSeconds = 0;
+        rule.renotifySeconds = settings.getAlertRenotifySec();
+        alerts.addRule(rule);
+    };
+    // "variable < clear threshold" for a limit
+    auto clearBelow = [this](const std::string &variable, int limit)
+    {
+        char threshold[32];
+        snprintf(threshold, sizeof(threshold), "%g", clearThreshold(limit));
+        return variable + " < " + threshold;
+    };
+
+    if (settings.getCpuLimit() > 0)
+    {
+        addLimit("cpu_limit", "cpu >= " + std::to_string(settings.getCpuLimit()), clearBelow("cpu", settings.getCpuLimit()),
+                 "CPU Warning!\nCpu : {cpu:0}%\n\nTop Processes :\n{top_cpu}", "CPU Resolved\nCpu : {cpu:0}%");
+    }
+    for (int mode = 0; mode < CPU_MODE_COUNT; mode++)
+    {
+        if (cpuModeLimits[mode] > 0)
+        {
+            std::string modeName = cpuModeName(mode);
+            addLimit("cpu_mode_limits." + modeName, "cpu." + modeName + " >= " + std::to_string(cpuModeLimits[mode]),
+                     clearBelow("cpu." + modeName, cpuModeLimits[mode]),
+                     "CPU " + modeName + " Warning!\nCpu " + modeName + " : {cpu." + modeName + ":0}%",
+                     "CPU " + modeName + " Resolved\nCpu " + modeName + " : {cpu." + modeName + ":0}%");
+        }
+    }
+    if (settings.getCoreLimit() > 0)
+    {
+        addLimit("core_limit", "core.longest_hot >= 0 && core.longest_hot_seconds >= " + std::to_string(settings.getCoreLimitDuration()), "",
+                 "CPU Core Warning!\ncpu{core.longest_hot} above " + std::to_string(settings.getCoreLimit()) + "% for {core.longest_hot_seconds:0}s",
+                 "CPU Core Resolved\nNo core above " + std::to_string(settings.getCoreLimit()) + "% for " + std::to_string(settings.getCoreLimitDuration()) + "s");
+    }
+    if (settings.getCoreImbalanceLimit() > 0)
+    {
+        addLimit("core_imbalance_limit", "core.hottest >= 0 && core.imbalance >= " + std::to_string(settings.getCoreImbalanceLimit()),
+                 "core.hottest < 0 || " + clearBelow("core.imbalance", settings.getCoreImbalanceLimit()),
+                 "CPU Imbalance Warning!\ncpu{core.hottest} : {core.hottest_usage:0}%\nAverage : {core.average:0}%",
+                 "CPU Imbalance Resolved\nAverage : {core.average:0}%");
+    }
+    if (settings.getMemoryLimit() > 0)
+    {
+        addLimit("memory_limit", "memory >= " + std::to_string(settings.getMemoryLimit()), clearBelow("memory", settings.getMemoryLimit()),
+                 "Memory Warning!\nMemory : {memory:0}%\n\nTop Processes :\n{top_memory}", "Memory Resolved\nMemory : {memory:0}%");
+    }
+    for (int resource = 0; resource < PRESSURE_RESOURCE_COUNT; resource++)
+    {
+        if (pressureLimits[resource] > 0)
+        {
+            std::string resourceName = PressureMonitor::resourceName(resource);
+            addLimit("psi_limits." + resourceName, "psi." + resourceName + " >= " + std::to_string(pressureLimits[resource]),
+                     clearBelow("psi." + resourceName, pressureLimits[resource]),
+                     "Pressure Warning!\n" + resourceName + " some avg10 : {psi." + resourceName + ":0}%",
+                     "Pressure Resolved\n" + resourceName + " some avg10 : {psi." + resourceName + ":0}%");
+        }
+    }
+    if (settings.getSwapLimit() > 0)
+    {
+        addLimit("swap_limit", "swap.total_mb > 0 && swap >= " + std::to_string(settings.getSwapLimit()),
+                 "swap.total_mb <= 0 || " + clearBelow("swap", settings.getSwapLimit()),
+                 "Swap Warning!\nSwap : {swap:0}%", "Swap Resolved\nSwap : {swap:0}%");
+    }
+    if (settings.getDirtyLimitMB() > 0)
+    {
+        addLimit("dirty_limit_mb", "dirty_mb >= " + std::to_string(settings.getDirtyLimitMB()), clearBelow("dirty_mb", settings.getDirtyLimitMB()),
+                 "Dirty Pages Warning!\nDirty : {dirty_mb:0} MB", "Dirty Pages Resolved\nDirty : {dirty_mb:0} MB");
+    }
+    if (settings.getCommitLimit() > 0)
+    {
+        addLimit("commit_limit", "commit >= " + std::to_string(settings.getCommitLimit()), clearBelow("commit", settings.getCommitLimit()),
+                 "Overcommit Warning!\nCommitted : {commit:0}% of commit limit",
+                 "Overcommit Resolved\nCommitted : {commit:0}% of commit limit");
+    }
+}
+
+/**
+ * @brief Sends an alert message to the configured chat.
+ *
+ * Used by collectors that detect a condition themselves, such as kernel PSI triggers,
+ * instead of being checked by `checkUsageLimits`.
+ *
+ * @param text Message to send.
+ */
+void TelegramMonitor::sendAlert(const std::string &text)
 {
+    logger.logToConsole("alert: " + text.substr(0, text.find('\n')));
+    outbound.sendMessage(settings.getChatId(), text, OUTBOUND_ALERT);
 }
 
 /**
@@ -41,147 +218,982 @@ void TelegramMonitor::startTelegramRequestThread()
 }
 
 /**
- * @brief Starts a new thread to monitor Telegram notifications.
+ * @brief Handles the /start command to initiate monitoring.
  *
- * This method creates and starts a new thread dedicated to monitoring and sending Telegram
- * notifications based on system metrics (such as CPU and memory usage). The thread executes
- * the `thread_telegramNotification` method, which is responsible for periodically checking
- * system status and sending notifications if certain thresholds are exceeded. The method
- * detaches the thread to allow it to run independently in the background.
+ * Checks if the user ID matches the allowed chat ID, logs the start command,
+ * enables monitoring, and sends a welcome message with available commands to the user.
  *
- * The steps performed by this method are:
+ * @param message Pointer to the incoming message containing the /start command.
+ */
+void TelegramMonitor::handleStartCommand(TgBot::Message::Ptr message)
+{
+    if (message->chat->id != settings.getChatId())
+        return;
+
+    logger.logToConsole("send /start command, start monitoring");
+    this->scheduler.resume();
+
+    outbound.sendMessage(message->chat->id,
+                         "Welcome to LinuxMonitoring\n"
+                         "\nCommands:\n"
+                         "/start    start monitoring\n"
+                         "/stop     stop monitoring\n"
+                         "/status   monitoring status\n"
+                         "/usage    get server status\n"
+                         "/net      get network interfaces\n"
+                         "/top      get top processes\n"
+                         "/history  get metric history\n"
+                         "/chart    get metric chart\n"
+                         "/export   export metric history\n"
+                         "/dashboard live dashboard\n"
+                         "/help     get bot command list\n"
+                         "\nMonitoring Status : Enable\n"
+                         "\nPowered By Mr.Mansouri");
+}
+
+/**
+ * @brief Handles the /stop command to disable monitoring.
  *
- * 1. **Thread Creation**: Creates a new `std::thread` object that runs the `thread_telegramNotification`
- *    method of the `TelegramMonitor` class. The `this` pointer is passed to the method, allowing
- *    it to access instance variables and methods.
+ * Checks if the user ID matches the allowed chat ID, logs the stop command,
+ * disables monitoring, and notifies the user that monitoring has been stopped.
  *
- * 2. **Thread Detachment**: Calls the `detach` method on the `std::thread` object. This allows the
- *    thread to execute independently and continue running in the background, without blocking
- *    the main thread. Detached threads run in parallel and are not synchronized with the main
- *    thread.
+ * @param message Pointer to the incoming message containing the /stop command.
+ */
+void TelegramMonitor::handleStopCommand(TgBot::Message::Ptr message)
+{
+    if (message->chat->id != settings.getChatId())
+        return;
+
+    logger.logToConsole("send /stop command, stop monitoring");
+    this->scheduler.pause();
+
+    outbound.sendMessage(message->chat->id,
+                         "Monitoring Stopped!\n"
+                         "\nMonitoring Status : Disable\n"
+                         "\n- To re-enable monitoring, please enter the /start command.\n"
+                         "\n- To check monitoring status, please enter the /status command.\n");
+}
+
+/**
+ * @brief Handles the /usage command to report server CPU and memory usage.
  *
- * **Note**: Since the thread is detached, ensure that all shared resources are properly synchronized
- * to avoid race conditions and data inconsistency.
+ * Checks if the user ID matches the allowed chat ID and logs the usage command.
+ * If monitoring is enabled, sends the current CPU and memory usage to the user.
+ * If monitoring is disabled, informs the user that monitoring is inactive.
+ * "/usage percentiles" reports percentiles of the last 5 minutes, hour and day instead.
  *
- * Example usage:
- * @code
- * TelegramMonitor monitor;
- * monitor.startTelegramNotificationWatchThread();
- * // The notificationThread will now be running and handling system notifications in the background.
- * @endcode
+ * @param message Pointer to the incoming message containing the /usage command.
  */
-void TelegramMonitor::startTelegramNotificationWatchThread()
+void TelegramMonitor::handleUsageCommand(TgBot::Message::Ptr message)
 {
-    // if monitoring enabled
-    if (this->tgNotificationStatus)
+    if (message->chat->id != settings.getChatId())
+        return;
+
+    logger.logToConsole("send /usage command");
+
+    if (!this->scheduler.isRunning())
+    {
+        outbound.sendMessage(message->chat->id,
+                             "Monitoring Status : Disable\n"
+                             "\nTo monitor the server again, please enter the /start command.");
+        return;
+    }
+
+    // "/usage percentiles", or any abbreviation of it ("/usage p", "/usage perc")
+    std::istringstream arguments(message->text);
+    std::string command, mode;
+    arguments >> command >> mode;
+    if (!mode.empty() && std::string("percentiles").compare(0, mode.size(), mode) == 0)
     {
+        outbound.sendMessage(message->chat->id, "Server Usage Percentiles (p50 / p90 / p99 / max) :\n" + formatPercentiles());
         return;
     }
 
-    // if monitoring disabled
-    this->tgNotificationStatus = true;
-    notificationThread = std::thread(&TelegramMonitor::thread_telegramNotification, this);
-    notificationThread.detach();
+    outbound.sendMessage(message->chat->id,
+                         "Server Usage :\n\n"
+                         "CPU : " +
+                             std::to_string(static_cast<int>(cpu.getLastCpuUsage())) +
+                             "%\nMemory : " + std::to_string(static_cast<int>(memory.getLastMemoryUsage())) + "%" +
+                             "\n\nMemory Details :\n" + formatMemoryDetails() +
+                             "\nCPU Breakdown :\n" + formatCpuBreakdown() +
+                             "\nHottest Cores :\n" + formatTopCores() +
+                             "\nPressure (some avg10/avg60/avg300) :\n" + formatPressure() +
+                             "\nDisks :\n" + formatDisks() +
+                             "\nLast Hour :\n" + formatSparklines());
 }
 
 /**
- * @brief Stops the Telegram notification watching thread.
+ * @brief Formats percentiles of the main metrics over the last 5 minutes, hour and day.
  *
- * This function sets the `tgNotificationStatus` flag to `false`,
- * indicating that the monitoring of Telegram notifications should
- * cease. As a result, the associated thread responsible for
- * observing notifications will be terminated, and the system will
- * no longer process incoming Telegram messages for monitoring.
+ * Every window is answered by merging the metric's quantile sketches (see
+ * `MetricStore::quantiles`), so a day costs the same as five minutes. Windows without
+ * samples, e.g. right after the first start, are reported as such.
  *
- * It is important to call this method when notification monitoring
- * is no longer needed to ensure proper resource management and
- * graceful termination of the associated thread.
+ * @return One block per metric with one line per window.
  */
-void TelegramMonitor::stopTelegramNotificationWatchThread()
+std::string TelegramMonitor::formatPercentiles()
 {
-    this->tgNotificationStatus = false;
+    static const char *metricNames[] = {"cpu", "memory", "swap", "psi.cpu", "psi.memory", "psi.io"};
+    static const struct
+    {
+        const char *label;
+        int64_t lengthMS;
+    } windows[] = {{"5 min", 5 * 60 * 1000LL}, {"1 hour", 3600 * 1000LL}, {"24 hours", 24 * 3600 * 1000LL}};
+
+    std::string text;
+    int64_t nowMS = MetricStore::nowMS();
+    for (const char *name : metricNames)
+    {
+        int id = metrics.find(name);
+        if (id < 0)
+        {
+            continue;
+        }
+
+        text += std::string("\n") + name + " :\n";
+        for (const auto &window : windows)
+        {
+            QuantileSketch sketch;
+            if (!metrics.quantiles(id, nowMS - window.lengthMS, nowMS, sketch))
+            {
+                return "\npercentiles are disabled (history_sketch_retention_hours)\n";
+            }
+
+            char line[96];
+            if (sketch.getCount() == 0)
+            {
+                snprintf(line, sizeof(line), "%s : no data\n", window.label);
+            }
+            else
+            {
+                snprintf(line, sizeof(line), "%s : %.1f / %.1f / %.1f / %.1f%%\n", window.label, sketch.quantile(0.5),
+                         sketch.quantile(0.9), sketch.quantile(0.99), sketch.getMax());
+            }
+            text += line;
+        }
+    }
+
+    return text.empty() ? "\nno recorded metrics\n" : text;
 }
 
 /**
- * @brief Handles the /start command to initiate monitoring.
+ * @brief Formats sparklines of cpu and memory over the last hour.
  *
- * Checks if the user ID matches the allowed chat ID, logs the start command,
- * enables monitoring, and sends a welcome message with available commands to the user.
+ * A text fallback for `/chart`: 24 characters of 2.5 minutes each, read from the finest
+ * rollup tier, on a 0-100% scale.
  *
- * @param message Pointer to the incoming message containing the /start command.
+ * @return One line per metric.
  */
-void TelegramMonitor::handleStartCommand(TgBot::Message::Ptr message)
+std::string TelegramMonitor::formatSparklines()
+{
+    static const char *metricNames[] = {"cpu", "memory"};
+    static const int64_t windowMS = 3600 * 1000LL;
+    static const size_t width = 24;
+
+    std::string text;
+    int64_t nowMS = MetricStore::nowMS();
+    for (const char *name : metricNames)
+    {
+        std::vector<RollupBucket> buckets;
+        if (metrics.aggregate(metrics.find(name), nowMS - windowMS, nowMS, windowMS / width, buckets) < 0)
+        {
+            continue;
+        }
+        text += std::string(name) + " " + ChartRenderer::sparkline(buckets, nowMS - windowMS, nowMS, width, 100.0) + "\n";
+    }
+
+    return text.empty() ? "no recorded metrics\n" : text;
+}
+
+/**
+ * @brief Formats the block device rates of the last sample.
+ *
+ * @return One line per monitored device with utilization, IOPS, throughput, await and queue depth.
+ */
+std::string TelegramMonitor::formatDisks()
+{
+    std::string text;
+
+    for (const DiskStats &stats : disk.getStats())
+    {
+        char line[160];
+        snprintf(line, sizeof(line), "%s : util %d%%, r/w %.0f/%.0f iops, %.1f/%.1f MB/s, await %.1f ms, queue %.1f\n",
+                 stats.name, static_cast<int>(stats.utilPercent), stats.readIops, stats.writeIops,
+                 stats.readBytesPerSec / 1048576.0, stats.writeBytesPerSec / 1048576.0, stats.awaitMS, stats.queueDepth);
+        text += line;
+    }
+
+    return text.empty() ? "no monitored devices\n" : text;
+}
+
+/**
+ * @brief Formats the Pressure Stall Information of the last sample.
+ *
+ * @return One line per available resource with its "some" stall averages.
+ */
+std::string TelegramMonitor::formatPressure()
+{
+    std::string text;
+
+    for (int resource = 0; resource < PRESSURE_RESOURCE_COUNT; resource++)
+    {
+        PressureStats stats = pressure.getStats(resource);
+        if (!stats.available)
+        {
+            continue;
+        }
+
+        char line[96];
+        snprintf(line, sizeof(line), "%s : %.2f%% / %.2f%% / %.2f%%\n", PressureMonitor::resourceName(resource), stats.some.avg10, stats.some.avg60, stats.some.avg300);
+        text += line;
+    }
+
+    return text.empty() ? "not available\n" : text;
+}
+
+/**
+ * @brief Formats the /proc/meminfo details of the last sample.
+ *
+ * @return Available memory, swap, dirty/writeback pages and overcommit, one per line.
+ */
+std::string TelegramMonitor::formatMemoryDetails()
+{
+    MemInfo info = memory.getLastMemInfo();
+
+    return "available : " + std::to_string(info.memAvailable / 1024) + " MB of " + std::to_string(info.memTotal / 1024) + " MB\n" +
+           "swap : " + std::to_string(static_cast<int>(info.swapUsagePercent())) + "% of " + std::to_string(info.swapTotal / 1024) + " MB\n" +
+           "dirty : " + std::to_string(info.dirty / 1024) + " MB, writeback : " + std::to_string(info.writeback / 1024) + " MB\n" +
+           "committed : " + std::to_string(static_cast<int>(info.commitPercent())) + "% of commit limit\n";
+}
+
+/**
+ * @brief Formats the hottest cores of the last sample.
+ *
+ * Lists up to `usage_top_cores` cores, busiest first, followed by the average of all cores.
+ *
+ * @return The formatted list.
+ */
+std::string TelegramMonitor::formatTopCores()
+{
+    std::string text;
+
+    for (const auto &core : cpu.getTopCores(settings.getUsageTopCores()))
+    {
+        text += "cpu" + std::to_string(core.first) + " : " + std::to_string(static_cast<int>(core.second)) + "%\n";
+    }
+
+    CpuCoreSummary summary = cpu.getCoreSummary();
+    text += "average : " + std::to_string(static_cast<int>(summary.averageUsage)) + "% of " + std::to_string(summary.onlineCores) + " cores\n";
+
+    return text;
+}
+
+/**
+ * @brief Formats the per-mode CPU breakdown of the last sample.
+ *
+ * One line per mode (idle excluded) with its share of the interval and the CPU seconds
+ * spent in it per second, e.g. "steal : 23% (0.92 cpu)".
+ *
+ * @return The formatted breakdown.
+ */
+std::string TelegramMonitor::formatCpuBreakdown()
+{
+    CpuUsage usage = cpu.getLastCpuBreakdown();
+    std::string text;
+
+    for (int mode = 0; mode < CPU_MODE_COUNT; mode++)
+    {
+        if (mode == CPU_IDLE)
+        {
+            continue;
+        }
+
+        char rate[32];
+        snprintf(rate, sizeof(rate), "%.2f", usage.rate[mode]);
+        text += std::string(cpuModeName(mode)) + " : " + std::to_string(static_cast<int>(usage.percent[mode])) + "% (" + rate + " cpu)\n";
+    }
+
+    return text;
+}
+
+/**
+ * @brief Handles the /net command to report network interface traffic.
+ *
+ * Lists the `net_top_interfaces` busiest interfaces of the last sample (by received plus
+ * transmitted bytes) with their throughput, packet rates, errors and drops. Hosts with
+ * hundreds of veth interfaces would not fit in one message, so the remaining interfaces
+ * are only counted.
+ *
+ * @param message Pointer to the incoming message containing the /net command.
+ */
+void TelegramMonitor::handleNetCommand(TgBot::Message::Ptr message)
 {
     if (message->chat->id != settings.getChatId())
         return;
 
-    logger.logToConsole("send /start command, start monitoring");
-    this->isMonitoringEnable = true;
+    logger.logToConsole("send /net command");
+
+    if (!this->scheduler.isRunning())
+    {
+        outbound.sendMessage(message->chat->id,
+                             "Monitoring Status : Disable\n"
+                             "\nTo monitor the server again, please enter the /start command.");
+        return;
+    }
+
+    std::vector<NetStats> interfaces = net.getStats();
+    size_t count = std::min(interfaces.size(), static_cast<size_t>(std::max(settings.getNetTopInterfaces(), 1)));
+    std::partial_sort(interfaces.begin(), interfaces.begin() + count, interfaces.end(), [](const NetStats &a, const NetStats &b)
+                      { return a.rxBytesPerSec + a.txBytesPerSec > b.rxBytesPerSec + b.txBytesPerSec; });
+
+    std::string text = "Network (rx / tx) :\n\n";
+    for (size_t i = 0; i < count; i++)
+    {
+        const NetStats &stats = interfaces[i];
+        char line[224];
+        snprintf(line, sizeof(line), "%s :\n  %.2f / %.2f Mbit/s\n  %.0f / %.0f pkt/s\n  errors %.1f / %.1f, drops %.1f / %.1f per s\n",
+                 stats.name, stats.rxBytesPerSec * 8 / 1000000.0, stats.txBytesPerSec * 8 / 1000000.0,
+                 stats.rxPacketsPerSec, stats.txPacketsPerSec, stats.rxErrorsPerSec, stats.txErrorsPerSec,
+                 stats.rxDropsPerSec, stats.txDropsPerSec);
+        text += line;
+    }
+    if (interfaces.empty())
+    {
+        text += "no monitored interfaces\n";
+    }
+    else if (interfaces.size() > count)
+    {
+        text += "\n+ " + std::to_string(interfaces.size() - count) + " quieter interfaces\n";
+    }
 
-    bot.getApi().sendMessage(message->chat->id,
-                             "Welcome to LinuxMonitoring\n"
-                             "\nCommands:\n"
-                             "/start    start monitoring\n"
-                             "/stop     stop monitoring\n"
-                             "/status   monitoring status\n"
-                             "/usage    get server status\n"
-                             "/help     get bot command list\n"
-                             "\nMonitoring Status : Enable\n"
-                             "\nPowered By Mr.Mansouri");
+    outbound.sendMessage(message->chat->id, text);
 }
 
 /**
- * @brief Handles the /stop command to disable monitoring.
+ * @brief Handles the /top command to report the heaviest processes.
  *
- * Checks if the user ID matches the allowed chat ID, logs the stop command,
- * disables monitoring, and notifies the user that monitoring has been stopped.
+ * Sends the `process_top_count` processes with the highest CPU share and the largest
+ * resident set size of the last process scan.
  *
- * @param message Pointer to the incoming message containing the /stop command.
+ * @param message Pointer to the incoming message containing the /top command.
  */
-void TelegramMonitor::handleStopCommand(TgBot::Message::Ptr message)
+void TelegramMonitor::handleTopCommand(TgBot::Message::Ptr message)
 {
     if (message->chat->id != settings.getChatId())
         return;
 
-    logger.logToConsole("send /stop command, stop monitoring");
-    this->isMonitoringEnable = false;
+    logger.logToConsole("send /top command");
+
+    if (!this->scheduler.isRunning())
+    {
+        outbound.sendMessage(message->chat->id,
+                             "Monitoring Status : Disable\n"
+                             "\nTo monitor the server again, please enter the /start command.");
+        return;
+    }
 
-    bot.getApi().sendMessage(message->chat->id,
-                             "Monitoring Stopped!\n"
-                             "\nMonitoring Status : Disable\n"
-                             "\n- To re-enable monitoring, please enter the /start command.\n"
-                             "\n- To check monitoring status, please enter the /status command.\n");
+    outbound.sendMessage(message->chat->id,
+                         "Top Processes by CPU :\n" + formatTopProcesses(true) +
+                             "\nTop Processes by Memory :\n" + formatTopProcesses(false));
 }
 
+// Rows of a /history reply, keeps the table well below Telegram's 4096 character limit
+static const int64_t HISTORY_MAX_ROWS = 60;
+
 /**
- * @brief Handles the /usage command to report server CPU and memory usage.
+ * @brief Parses a duration such as "90s", "15m", "6h" or "30d" (plain numbers are seconds).
  *
- * Checks if the user ID matches the allowed chat ID and logs the usage command.
- * If monitoring is enabled, sends the current CPU and memory usage to the user.
- * If monitoring is disabled, informs the user that monitoring is inactive.
+ * Amounts whose duration would overflow are rejected; durations above `maxMS` (the longest
+ * retention, `MetricStore::getRetentionMS`) are clamped to it and `text` is rewritten to
+ * the clamped duration, so replies name the range actually covered.
  *
- * @param message Pointer to the incoming message containing the /usage command.
+ * @return True if the text is a positive duration.
  */
-void TelegramMonitor::handleUsageCommand(TgBot::Message::Ptr message)
+static bool parseDuration(std::string &text, int64_t &durationMS, int64_t maxMS)
+{
+    char *end = nullptr;
+    long long amount = std::strtoll(text.c_str(), &end, 10);
+    if (end == text.c_str() || amount <= 0)
+    {
+        return false;
+    }
+
+    std::string unit(end);
+    int64_t unitMS = unit.empty() || unit == "s" ? 1000LL : unit == "m" ? 60 * 1000LL : unit == "h" ? 3600 * 1000LL : unit == "d" ? 24 * 3600 * 1000LL : 0;
+    if (unitMS == 0 || amount > INT64_MAX / unitMS)
+    {
+        return false;
+    }
+    durationMS = amount * unitMS;
+    if (maxMS > 0 && durationMS > maxMS)
+    {
+        durationMS = maxMS;
+        const int64_t dayMS = 24 * 3600 * 1000LL;
+        text = maxMS % dayMS == 0 ? std::to_string(maxMS / dayMS) + "d" : std::to_string(maxMS / 1000) + "s";
+    }
+    return true;
+}
+
+/**
+ * @brief Handles the /history command to report the stored history of a metric.
+ *
+ * Usage: "/history <metric> <range> [step]", e.g. "/history cpu 7d 6h". Replies with one
+ * row of min/avg/max per step, read by `MetricStore::aggregate` from the coarsest rollup
+ * tier that fits the step. Without a step (or with one that would exceed
+ * `HISTORY_MAX_ROWS` rows) the range is split into at most that many rows. The history is
+ * available while monitoring is stopped too.
+ *
+ * @param message Pointer to the incoming message containing the /history command.
+ */
+void TelegramMonitor::handleHistoryCommand(TgBot::Message::Ptr message)
 {
     if (message->chat->id != settings.getChatId())
         return;
 
-    logger.logToConsole("send /usage command");
+    logger.logToConsole("send /history command");
+
+    std::istringstream arguments(message->text);
+    std::string command, name, range, step;
+    arguments >> command >> name >> range >> step;
+
+    int id = metrics.find(name);
+    int64_t rangeMS = 0, stepMS = 0;
+    if (id < 0 || !parseDuration(range, rangeMS, metrics.getRetentionMS()) || (!step.empty() && !parseDuration(step, stepMS, metrics.getRetentionMS())))
+    {
+        std::string names;
+        for (const std::string &metric : metrics.getNames())
+        {
+            names += (names.empty() ? "" : ", ") + metric;
+        }
+        outbound.sendMessage(message->chat->id,
+                             "Usage : /history <metric> <range> [step]\n"
+                             "e.g. /history cpu 24h 1h\n"
+                             "\nRanges and steps : 90s, 15m, 6h, 30d\n"
+                             "\nMetrics : " + names);
+        return;
+    }
+
+    int64_t minStepMS = (rangeMS + HISTORY_MAX_ROWS - 1) / HISTORY_MAX_ROWS;
+    if (stepMS < minStepMS)
+    {
+        // round up to whole seconds, so rows start at readable times
+        stepMS = (minStepMS + 999) / 1000 * 1000;
+    }
+
+    int64_t nowMS = MetricStore::nowMS();
+    std::vector<RollupBucket> buckets;
+    int64_t resolutionMS = metrics.aggregate(id, nowMS - rangeMS, nowMS, stepMS, buckets);
+
+    std::string text = "History of " + name + " (last " + range + ", step " + std::to_string(stepMS / 1000) + " s, " +
+                       (resolutionMS > 0 ? std::to_string(resolutionMS / 1000) + " s buckets" : std::string("raw samples")) +
+                       ") :\n\ntime : min / avg / max\n";
+    const char *timeFormat = rangeMS > 24 * 3600 * 1000LL ? "%m-%d %H:%M" : stepMS < 60 * 1000 ? "%H:%M:%S" : "%H:%M";
+    for (const RollupBucket &bucket : buckets)
+    {
+        time_t startTime = static_cast<time_t>(bucket.startMS / 1000);
+        struct tm local;
+        localtime_r(&startTime, &local);
+        char time[32];
+        strftime(time, sizeof(time), timeFormat, &local);
+
+        char line[96];
+        snprintf(line, sizeof(line), "%s : %.1f / %.1f / %.1f\n", time, bucket.min, bucket.average(), bucket.max);
+        text += line;
+    }
+    if (buckets.empty())
+    {
+        text += "no samples in this range\n";
+    }
+
+    outbound.sendMessage(message->chat->id, text);
+}
+
+/**
+ * @brief Returns the configured limits of a metric, drawn as threshold markers in charts.
+ */
+std::vector<double> TelegramMonitor::metricThresholds(const std::string &name)
+{
+    std::vector<double> thresholds;
+    if (name == "cpu")
+    {
+        thresholds.push_back(settings.getCpuLimit());
+    }
+    else if (name == "memory")
+    {
+        thresholds.push_back(settings.getMemoryLimit());
+    }
+    else if (name == "swap")
+    {
+        thresholds.push_back(settings.getSwapLimit());
+    }
+    else if (name.compare(0, 4, "cpu.") == 0)
+    {
+        int mode = cpuModeFromName(name.c_str() + 4);
+        if (mode >= 0)
+        {
+            thresholds.push_back(cpuModeLimits[mode]);
+        }
+    }
+    else if (name.compare(0, 4, "psi.") == 0)
+    {
+        int resource = PressureMonitor::resourceFromName(name.substr(4));
+        if (resource >= 0)
+        {
+            thresholds.push_back(pressureLimits[resource]);
+        }
+    }
+    return thresholds;
+}
+
+/**
+ * @brief Handles the /chart command to send a PNG chart of a metric.
+ *
+ * Usage: "/chart <metric> [range]", e.g. "/chart cpu 24h" (default 1h). The range is
+ * aggregated by `MetricStore::aggregate` into about one bucket per pixel column, which
+ * reads the rollup tiers for every range longer than a few hours, and rendered with the
+ * metric's configured limit as a dashed marker. Rendering and encoding take about a
+ * millisecond; the image is a few kilobytes.
+ *
+ * @param message Pointer to the incoming message containing the /chart command.
+ */
+void TelegramMonitor::handleChartCommand(TgBot::Message::Ptr message)
+{
+    if (message->chat->id != settings.getChatId())
+        return;
+
+    logger.logToConsole("send /chart command");
+
+    std::istringstream arguments(message->text);
+    std::string command, name, range;
+    arguments >> command >> name >> range;
+    if (range.empty())
+    {
+        range = "1h";
+    }
+
+    int id = metrics.find(name);
+    int64_t rangeMS = 0;
+    if (id < 0 || !parseDuration(range, rangeMS, metrics.getRetentionMS()))
+    {
+        std::string names;
+        for (const std::string &metric : metrics.getNames())
+        {
+            names += (names.empty() ? "" : ", ") + metric;
+        }
+        outbound.sendMessage(message->chat->id,
+                             "Usage : /chart <metric> [range]\n"
+                             "e.g. /chart cpu 24h\n"
+                             "\nMetrics : " + names);
+        return;
+    }
+
+    int64_t nowMS = MetricStore::nowMS();
+    int64_t stepMS = std::max<int64_t>(rangeMS / chartRenderer.getWidth(), 1000);
+    std::vector<RollupBucket> buckets;
+    metrics.aggregate(id, nowMS - rangeMS, nowMS, stepMS, buckets);
+    if (buckets.empty())
+    {
+        outbound.sendMessage(message->chat->id, "No samples of " + name + " in the last " + range);
+        return;
+    }
+
+    TgBot::InputFile::Ptr photo(new TgBot::InputFile);
+    photo->data = chartRenderer.renderPng(buckets, nowMS - rangeMS, nowMS, metricThresholds(name));
+    photo->mimeType = "image/png";
+    photo->fileName = name + ".png";
+    std::string caption = name + ", last " + range + " (average, min-max band, limit dashed)";
+    int64_t chatId = message->chat->id;
+    outbound.sendRequest(chatId, "chart " + name, [chatId, photo, caption](const TgBot::Api &api)
+                         { api.sendPhoto(chatId, photo, caption); });
+}
+
+/**
+ * @brief Handles the /export command to send the stored history as a file.
+ *
+ * Usage: "/export <range> [csv|columnar] [metric ...]", e.g. "/export 30d columnar cpu memory"
+ * (default CSV of all metrics). The history is streamed by `HistoryExporter` into a
+ * temporary file, which is read into memory, removed and queued for upload with `sendDocument`.
+ * Files above the 50 MB upload limit of the Bot API are not read; the reply asks for a
+ * shorter range, fewer metrics or the columnar format instead, so memory stays bounded.
+ *
+ * @param message Pointer to the incoming message containing the /export command.
+ */
+void TelegramMonitor::handleExportCommand(TgBot::Message::Ptr message)
+{
+    if (message->chat->id != settings.getChatId())
+        return;
+
+    logger.logToConsole("send /export command");
+
+    std::istringstream arguments(message->text);
+    std::string command, range, word;
+    arguments >> command >> range;
+
+    HistoryExporter::Format format = HistoryExporter::CSV;
+    std::vector<int> ids;
+    bool valid = true;
+    while (arguments >> word)
+    {
+        if (word == "csv" || word == "columnar")
+        {
+            format = word == "csv" ? HistoryExporter::CSV : HistoryExporter::COLUMNAR;
+            continue;
+        }
+        int id = metrics.find(word);
+        valid = valid && id >= 0;
+        ids.push_back(id);
+    }
+    if (ids.empty())
+    {
+        for (size_t id = 0; id < metrics.getNames().size(); id++)
+        {
+            ids.push_back(static_cast<int>(id));
+        }
+    }
+
+    int64_t rangeMS = 0;
+    if (!valid || !parseDuration(range, rangeMS, metrics.getRetentionMS()))
+    {
+        outbound.sendMessage(message->chat->id,
+                             "Usage : /export <range> [csv|columnar] [metric ...]\n"
+                             "e.g. /export 7d csv cpu memory\n"
+                             "\nWithout metrics, all metrics are exported.");
+        return;
+    }
+
+    const char *extension = format == HistoryExporter::CSV ? "csv" : "lmcol";
+    char path[] = "/tmp/linux_monitoring_export_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        logger.logToConsole("Export: failed to create a temporary file");
+        outbound.sendMessage(message->chat->id, "Export failed");
+        return;
+    }
+    close(fd);
+
+    int64_t nowMS = MetricStore::nowMS();
+    HistoryExporter exporter(metrics);
+    long long rows = exporter.write(path, format, ids, nowMS - rangeMS, nowMS);
+    if (rows < 0)
+    {
+        unlink(path);
+        outbound.sendMessage(message->chat->id, "Export failed");
+        return;
+    }
+
+    struct stat status;
+    if (stat(path, &status) != 0)
+    {
+        unlink(path);
+        outbound.sendMessage(message->chat->id, "Export failed");
+        return;
+    }
+    if (status.st_size > MAX_UPLOAD_BYTES)
+    {
+        unlink(path);
+        std::string hint = format == HistoryExporter::CSV ? "a shorter range, fewer metrics or columnar" : "a shorter range or fewer metrics";
+        outbound.sendMessage(message->chat->id, "Export of " + std::to_string(rows) + " rows is " + std::to_string(status.st_size / (1024 * 1024)) +
+                                                    " MB, above Telegram's 50 MB upload limit.\nUse " + hint + ".");
+        return;
+    }
+
+    TgBot::InputFile::Ptr document = TgBot::InputFile::fromFile(path, format == HistoryExporter::CSV ? "text/csv" : "application/octet-stream");
+    unlink(path);
+    document->fileName = std::string("history_") + range + "." + extension;
+    std::string caption = "History of the last " + range + ", " + std::to_string(rows) + " rows";
+    int64_t chatId = message->chat->id;
+    outbound.sendRequest(chatId, "export " + document->fileName, [chatId, document, caption](const TgBot::Api &api)
+                         { api.sendDocument(chatId, document, "", caption); });
+}
+
+/**
+ * @brief Handles the /dashboard command to start or stop the live dashboard.
+ *
+ * "/dashboard" posts a new dashboard message and pins it; `refreshDashboard` then keeps it
+ * up to date by editing it in place. A running dashboard is replaced by the new one.
+ * "/dashboard off" stops the refreshes and unpins the message.
+ *
+ * Every command bumps `dashboardGeneration`. A post that is still queued when a later
+ * command arrives is skipped, and one that was being sent is deleted again, so neither
+ * "/dashboard off" nor a quick second "/dashboard" leaves an orphaned dashboard.
+ *
+ * @param message Pointer to the incoming message containing the /dashboard command.
+ */
+void TelegramMonitor::handleDashboardCommand(TgBot::Message::Ptr message)
+{
+    if (message->chat->id != settings.getChatId())
+        return;
 
-    if (!this->isMonitoringEnable)
+    logger.logToConsole("send /dashboard command");
+
+    std::istringstream arguments(message->text);
+    std::string command, mode;
+    arguments >> command >> mode;
+
+    int64_t chatId = message->chat->id;
+    uint32_t generation = ++dashboardGeneration;
+    int32_t previousId = dashboardMessageId.exchange(0);
+    if (previousId != 0)
+    {
+        outbound.sendRequest(chatId, "unpin dashboard", [chatId, previousId](const TgBot::Api &api)
+                             { api.unpinChatMessage(chatId, previousId); });
+    }
+
+    if (mode == "off")
+    {
+        outbound.sendMessage(chatId, previousId != 0 ? "Dashboard stopped" : "No dashboard running");
+        return;
+    }
+
+    outbound.sendRequest(chatId, "dashboard", [this, chatId, generation](const TgBot::Api &api)
+                         {
+                             if (generation != dashboardGeneration)
+                             {
+                                 return;
+                             }
+                             TgBot::Message::Ptr posted = api.sendMessage(chatId, "Live Dashboard\n\nWaiting for the first refresh ...");
+                             int32_t postedId = posted->messageId;
+                             dashboardMessageId = postedId;
+                             // nothing may throw after the post, a retry would post a second dashboard
+                             if (generation != dashboardGeneration)
+                             {
+                                 int32_t expected = postedId;
+                                 dashboardMessageId.compare_exchange_strong(expected, 0);
+                                 try
+                                 {
+                                     api.deleteMessage(chatId, postedId);
+                                 }
+                                 catch (std::exception &e)
+                                 {
+                                     logger.logToConsole(std::string("Dashboard: cannot delete a replaced dashboard (") + e.what() + ")");
+                                 }
+                                 return;
+                             }
+                             try
+                             {
+                                 api.pinChatMessage(chatId, postedId, true);
+                             }
+                             catch (std::exception &e)
+                             {
+                                 logger.logToConsole(std::string("Dashboard: cannot pin the message (") + e.what() + ")");
+                             } });
+}
+
+// FNV-1a hash of a rendered dashboard
+static uint64_t hashText(const std::string &text)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : text)
+    {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Refreshes the live dashboard.
+ *
+ * Executed periodically by the `Scheduler` thread (`dashboard_interval_sec`) while
+ * monitoring is enabled. The dashboard is rendered with whole numbers and hashed; the edit
+ * is only queued when the hash differs from the last edit, so a steady system costs no API
+ * call at all and a busy one at most one per interval. Edits go through the outbound
+ * queue like every other request, but only one at a time: while an edit is queued (or
+ * waits for Telegram's `retry_after`) a refresh only replaces the text it will send, so a
+ * rate-limited bot does not pile up edits that go out back to back. The hash is only
+ * recorded once an edit was delivered, so an edit dropped from a full queue or failed is
+ * sent again on the next refresh. If the message was deleted the dashboard stops.
+ */
+void TelegramMonitor::refreshDashboard()
+{
+    int32_t messageId = dashboardMessageId;
+    if (messageId == 0)
+    {
+        return;
+    }
+
+    std::string text = formatDashboard();
+    uint64_t hash = hashText(text);
+    if (messageId == dashboardShownId && hash == dashboardHash)
     {
-        bot.getApi().sendMessage(message->chat->id,
-                                 "Monitoring Status : Disable\n"
-                                 "\nTo monitor the server again, please enter the /start command.");
         return;
     }
 
-    bot.getApi().sendMessage(message->chat->id,
-                             "Server Usage :\n\n"
-                             "CPU : " +
-                                 std::to_string(static_cast<int>(cpu.getLastCpuUsage())) +
-                                 "%\nMemory : " + std::to_string(static_cast<int>(memory.getLastMemoryUsage())) + "%");
+    time_t now = time(nullptr);
+    char updated[32];
+    strftime(updated, sizeof(updated), "%H:%M:%S", localtime(&now));
+    text += std::string("\nUpdated ") + updated;
+
+    {
+        std::lock_guard<std::mutex> lock(dashboardMutex);
+        dashboardPendingId = messageId;
+        dashboardPendingText = text;
+        dashboardPendingHash = hash;
+        if (dashboardEditQueued)
+        {
+            return; // the queued edit sends this text
+        }
+        dashboardEditQueued = true;
+    }
+
+    int64_t chatId = settings.getChatId();
+    if (!outbound.sendRequest(chatId, "dashboard update", [this, chatId](const TgBot::Api &api)
+                              { editDashboard(api, chatId); }))
+    {
+        std::lock_guard<std::mutex> lock(dashboardMutex);
+        dashboardEditQueued = false;
+    }
+}
+
+/**
+ * @brief Sends the pending dashboard edit, called on the sender thread.
+ *
+ * Sends the text of the latest refresh, not the one that queued the edit. Only "retry
+ * after" errors are left to the outbound queue, which waits as long as Telegram asks and
+ * keeps the edit queued meanwhile; any other failure ends the edit here and the next
+ * refresh queues a new one, so there is never more than one edit per interval.
+ */
+void TelegramMonitor::editDashboard(const TgBot::Api &api, int64_t chatId)
+{
+    int32_t messageId;
+    std::string text;
+    uint64_t hash;
+    {
+        std::lock_guard<std::mutex> lock(dashboardMutex);
+        messageId = dashboardPendingId;
+        text = dashboardPendingText;
+        hash = dashboardPendingHash;
+    }
+
+    try
+    {
+        if (messageId == dashboardMessageId)
+        {
+            api.editMessageText(text, chatId, messageId);
+            dashboardHash = hash;
+            dashboardShownId = messageId;
+        }
+    }
+    catch (TgBot::TgException &e)
+    {
+        std::string error = e.what();
+        if (error.find("retry after") != std::string::npos)
+        {
+            throw;
+        }
+        if (error.find("message is not modified") != std::string::npos)
+        {
+            dashboardHash = hash;
+            dashboardShownId = messageId;
+        }
+        else if (error.find("message to edit not found") != std::string::npos)
+        {
+            int32_t expected = messageId;
+            dashboardMessageId.compare_exchange_strong(expected, 0);
+            logger.logToConsole("Dashboard message deleted, dashboard stopped");
+        }
+        else
+        {
+            logger.logToConsole("Dashboard: edit failed (" + error + "), retried on the next refresh");
+        }
+    }
+    catch (std::exception &e)
+    {
+        logger.logToConsole(std::string("Dashboard: edit failed (") + e.what() + "), retried on the next refresh");
+    }
+
+    std::lock_guard<std::mutex> lock(dashboardMutex);
+    dashboardEditQueued = false;
+}
+
+/**
+ * @brief Renders the live dashboard.
+ *
+ * Usage, pressure, the busiest devices and the firing alerts, all as whole numbers so the
+ * text (and its hash) only changes when something changes noticeably. Reads the alert
+ * states, so it must run on the scheduler thread.
+ *
+ * @return Dashboard text without the update time.
+ */
+std::string TelegramMonitor::formatDashboard()
+{
+    MemInfo info = memory.getLastMemInfo();
+    char line[160];
+    std::string text = "Live Dashboard " + settings.getNodeName() + "\n\n";
+
+    snprintf(line, sizeof(line), "CPU : %d%%\nMemory : %d%%\nSwap : %d%%\n", static_cast<int>(cpu.getLastCpuUsage()),
+             static_cast<int>(memory.getLastMemoryUsage()), static_cast<int>(info.swapUsagePercent()));
+    text += line;
+
+    std::string stalls;
+    for (int resource = 0; resource < PRESSURE_RESOURCE_COUNT; resource++)
+    {
+        PressureStats stats = pressure.getStats(resource);
+        if (stats.available)
+        {
+            stalls += std::string(stalls.empty() ? "" : ", ") + PressureMonitor::resourceName(resource) + " " + std::to_string(static_cast<int>(stats.some.avg10)) + "%";
+        }
+    }
+    if (!stalls.empty())
+    {
+        text += "Pressure : " + stalls + "\n";
+    }
+
+    for (const DiskStats &stats : disk.getStats())
+    {
+        snprintf(line, sizeof(line), "Disk %s : util %d%%\n", stats.name, static_cast<int>(stats.utilPercent));
+        text += line;
+    }
+    for (const NetStats &stats : net.getStats())
+    {
+        int rxMbps = static_cast<int>(stats.rxBytesPerSec * 8 / 1000000.0);
+        int txMbps = static_cast<int>(stats.txBytesPerSec * 8 / 1000000.0);
+        if (rxMbps > 0 || txMbps > 0)
+        {
+            snprintf(line, sizeof(line), "Net %s : rx %d / tx %d Mbit/s\n", stats.name, rxMbps, txMbps);
+            text += line;
+        }
+    }
+
+    std::string firing;
+    for (size_t rule = 0; rule < alerts.getRuleCount(); rule++)
+    {
+        if (alerts.getState(static_cast<int>(rule)).phase == ALERT_FIRING)
+        {
+            firing += "- " + alerts.getRuleName(static_cast<int>(rule)) + "\n";
+        }
+    }
+    for (const auto &device : deviceAlerts)
+    {
+        if (device.second.phase == ALERT_FIRING)
+        {
+            firing += "- " + device.first + "\n";
+        }
+    }
+    text += "\nFiring Alerts :\n" + (firing.empty() ? std::string("none\n") : firing);
+
+    return text.size() > OutboundQueue::MAX_MESSAGE_LENGTH - 32 ? text.substr(0, OutboundQueue::MAX_MESSAGE_LENGTH - 32) : text;
+}
+
+/**
+ * @brief Formats the top processes of the last process scan.
+ *
+ * @param byCpu List the busiest processes if true, the largest ones otherwise.
+ * @return One line per process with pid, name, CPU share and RSS.
+ */
+std::string TelegramMonitor::formatTopProcesses(bool byCpu)
+{
+    std::string text;
+
+    for (const ProcessStats &stats : byCpu ? processes.getTopByCpu() : processes.getTopByMemory())
+    {
+        char line[96];
+        snprintf(line, sizeof(line), "%d %s : %.1f%% cpu, %llu MB\n", stats.pid, stats.name, stats.cpuPercent,
+                 static_cast<unsigned long long>(stats.rssKB / 1024));
+        text += line;
+    }
+
+    return text.empty() ? "no process scan yet\n" : text;
 }
 
 /**
@@ -197,12 +1209,19 @@ void TelegramMonitor::handleHelpCommand(TgBot::Message::Ptr message)
     if (message->chat->id != settings.getChatId())
         return;
 
-    bot.getApi().sendMessage(message->chat->id,
-                             "Commands:\n\n"
-                             "/start    start server monitoring\n"
-                             "/stop     stop server monitoring\n"
-                             "/status   get server monitoring status\n"
-                             "/usage    get server usage\n");
+    outbound.sendMessage(message->chat->id,
+                         "Commands:\n\n"
+                         "/start    start server monitoring\n"
+                         "/stop     stop server monitoring\n"
+                         "/status   get server monitoring status\n"
+                         "/usage    get server usage\n"
+                         "/usage percentiles  get p50/p90/p99/max of the last 5 min, hour and day\n"
+                         "/net      get network interface traffic\n"
+                         "/top      get top processes by cpu and memory\n"
+                         "/history <metric> <range> [step]  get min/avg/max per step, e.g. /history cpu 24h 1h\n"
+                         "/chart <metric> [range]  get a chart of a metric, e.g. /chart cpu 24h\n"
+                         "/export <range> [csv|columnar] [metric ...]  get the history as a file\n"
+                         "/dashboard [off]  pin a live dashboard that is edited in place\n");
 }
 
 /**
@@ -218,11 +1237,42 @@ void TelegramMonitor::handleStatusCommand(TgBot::Message::Ptr message)
     if (message->chat->id != settings.getChatId())
         return;
 
-    std::string statusString = this->isMonitoringEnable ? "Enable" : "Disable";
-    bot.getApi().sendMessage(message->chat->id,
-                             "Monitoring Status : " + statusString + "\n"
-                                                                     "\n/start    start server monitoring\n"
-                                                                     "/stop     stop server monitoring\n");
+    std::string statusString = this->scheduler.isRunning() ? "Enable" : "Disable";
+    outbound.sendMessage(message->chat->id,
+                         "Monitoring Status : " + statusString + "\n"
+                                                                 "\nAlert latency (sample to ...)\n" +
+                             formatLatency("evaluated", evaluationLatency) + formatLatency("alert queued", alertLatency) +
+                             "\nOutbound Queue :\n" + formatOutboundStats() +
+                             "\n/start    start server monitoring\n"
+                             "/stop     stop server monitoring\n");
+}
+
+// Depth per lane and counters of the outbound queue for `/status`
+std::string TelegramMonitor::formatOutboundStats()
+{
+    OutboundStats stats = outbound.getStats();
+    return "queued : " + std::to_string(stats.depth[OUTBOUND_CRITICAL]) + " critical, " + std::to_string(stats.depth[OUTBOUND_ALERT]) +
+           " alerts, " + std::to_string(stats.depth[OUTBOUND_REPLY]) + " replies\n"
+           "sent : " + std::to_string(stats.sent) + ", retries : " + std::to_string(stats.retries) +
+           ", dropped : " + std::to_string(stats.dropped) + ", failed : " + std::to_string(stats.failed) +
+           ", merged alerts : " + std::to_string(stats.coalesced) + "\n"
+           "api requests : " + std::to_string(httpClient.getRequestCount()) +
+           ", connections : " + std::to_string(httpClient.getConnectionCount()) + "\n";
+}
+
+// One line of latency percentiles for `/status`
+std::string TelegramMonitor::formatLatency(const std::string &label, const LatencyHistogram &histogram)
+{
+    if (histogram.getCount() == 0)
+    {
+        return label + " : no samples\n";
+    }
+
+    char line[160];
+    snprintf(line, sizeof(line), "%s : p50 %.1f ms, p99 %.1f ms, max %.1f ms (%llu)\n", label.c_str(),
+             histogram.quantileUS(0.5) / 1000.0, histogram.quantileUS(0.99) / 1000.0, histogram.getMaxUS() / 1000.0,
+             static_cast<unsigned long long>(histogram.getCount()));
+    return line;
 }
 
 /**
@@ -233,7 +1283,9 @@ void TelegramMonitor::handleStatusCommand(TgBot::Message::Ptr message)
  * loop to keep the bot actively processing incoming messages and commands.
  *
  * This function also outputs bot and user details (username, chat ID, API token)
- * for debugging purposes.
+ * for debugging purposes. The HTTP client does not retry (see `PooledHttpClient`), so
+ * transport errors and errors returned by Telegram restart polling after
+ * `LONG_POLL_RETRY_SEC`; only a rejected token (401, 404) ends the bot thread.
  */
 void TelegramMonitor::thread_telegramBot()
 {
@@ -247,6 +1299,18 @@ void TelegramMonitor::thread_telegramBot()
                               { handleHelpCommand(message); });
     bot.getEvents().onCommand("status", [this](TgBot::Message::Ptr message)
                               { handleStatusCommand(message); });
+    bot.getEvents().onCommand("net", [this](TgBot::Message::Ptr message)
+                              { handleNetCommand(message); });
+    bot.getEvents().onCommand("top", [this](TgBot::Message::Ptr message)
+                              { handleTopCommand(message); });
+    bot.getEvents().onCommand("history", [this](TgBot::Message::Ptr message)
+                              { handleHistoryCommand(message); });
+    bot.getEvents().onCommand("chart", [this](TgBot::Message::Ptr message)
+                              { handleChartCommand(message); });
+    bot.getEvents().onCommand("export", [this](TgBot::Message::Ptr message)
+                              { handleExportCommand(message); });
+    bot.getEvents().onCommand("dashboard", [this](TgBot::Message::Ptr message)
+                              { handleDashboardCommand(message); });
 
     try
     {
@@ -257,76 +1321,231 @@ void TelegramMonitor::thread_telegramBot()
         TgBot::TgLongPoll longPoll(bot);
         while (true)
         {
-            longPoll.start();
+            try
+            {
+                longPoll.start();
+            }
+            catch (TgBot::TgException &e)
+            {
+                // a bad token never recovers; 5xx replies and proxy error pages do
+                if (e.errorCode == TgBot::TgException::ErrorCode::Unauthorized || e.errorCode == TgBot::TgException::ErrorCode::NotFound)
+                {
+                    throw;
+                }
+                std::cerr << "long poll error : " << e.what() << std::endl;
+                sleep(LONG_POLL_RETRY_SEC);
+            }
+            catch (std::exception &e)
+            {
+                // transport error (network down, timeout): keep polling once it is back
+                std::cerr << "long poll error : " << e.what() << std::endl;
+                sleep(LONG_POLL_RETRY_SEC);
+            }
         }
     }
-    catch (TgBot::TgException &e)
+    catch (std::exception &e)
     {
         std::cerr << "error : " << e.what() << std::endl;
     }
 }
 
 /**
- * @brief Periodically checks CPU and memory usage and sends notifications if usage exceeds predefined limits.
+ * @brief Evaluates the alert rules and the device limits and sends warnings.
  *
- * This method initializes a Telegram bot and continuously monitors the CPU and memory usage
- * of the system. It compares the current usage against predefined limits specified in the settings.
- * If the CPU or memory usage exceeds the respective limit, it sends a warning message to the
- * designated Telegram chat.
+ * This method is executed by the `Scheduler` thread whenever collectors published new
+ * samples (`SampleEvents`), so alerts follow the sampling rate of the metrics they read
+ * rather than a fixed polling period.
  *
- * The method operates as follows:
+ * 1. **Alert Rules**:
+ *    - The latest values of the collectors with new samples are copied into the alert
+ *      variables (`AlertVariables::update`) and the rules that depend on them are evaluated. This covers the scalar limits
+ *      (`cpu_limit`, `cpu_mode_limits`, `core_limit`, `core_imbalance_limit`, `memory_limit`,
+ *      `psi_limits`, `swap_limit`, `dirty_limit_mb`, `commit_limit`, see `addLimitRules`) and
+ *      the rules of `alert_rules`. Kernel PSI triggers do not go through the rules, they call
+ *      `sendAlert` directly.
+ *    - A rule sends its message when it fires (its condition held for its `for_sec`), a
+ *      reminder every `renotify_sec` while it keeps firing, and its resolved message once
+ *      the clear condition holds. Nothing is sent while the state does not change.
  *
- * 1. **Bot Initialization**: Creates an instance of `TgBot::Bot` using the bot token retrieved
- *    from settings.
+ * 2. **Disk Check**:
+ *    - Warnings for block devices whose utilization reaches `disk_util_limit` or whose average
+ *      request latency reaches `disk_await_limit_ms`, after a new disk sample.
  *
- * 2. **Monitoring Loop**:
- *    - The loop runs indefinitely, continuously checking system resource usage.
- *    - **Monitoring Check**: If monitoring is disabled (i.e., `isMonitoringEnable` is false),
- *      the thread sleeps for a short period (1 second) and then continues to the next iteration.
+ * 3. **Network Check**:
+ *    - For interfaces with a `net_limits` entry, warnings when the receive or transmit
+ *      throughput, the error rate or the drop rate reaches the limit, after a new network sample.
  *
- * 3. **CPU Usage Check**:
- *    - If a CPU usage limit is defined and the current CPU usage exceeds this limit, a log message
- *      is recorded and a warning message is sent to the designated chat.
+ * Devices and interfaces come and go at runtime, so their limits are checked per device
+ * here; rules see them through the `disk.max_*` and `net.max_*` variables. Device warnings
+ * follow the same states as the rules (see `updateDeviceAlert`); the alerts of a device
+ * that disappeared are resolved after the pass (see `resolveMissingDevices`).
  *
- * 4. **Memory Usage Check**:
- *    - If a memory usage limit is defined and the current memory usage exceeds this limit, a log
- *      message is recorded and a warning message is sent to the designated chat.
+ * The time from the oldest new sample to the end of the rule evaluation, and to every
+ * queued rule alert, is recorded in `evaluationLatency` and `alertLatency` (see `/status`).
  *
- * 5. **Delay**:
- *    - The thread sleeps for a short period (500 milliseconds) before performing the next check.
+ * @param sources Mask of `sampleSourceBit` of the collectors with new samples.
+ * @param sampleNS Time of the oldest new sample (`SampleEvents::nowNS`).
  *
- * **Note**: Ensure that the `settings.getChatId()`, `settings.getCpuLimit()`, and
- * `settings.getMemoryLimit()` methods return valid values for the bot to function properly.
- * The bot must have sufficient permissions to send messages to the specified chat.
- *
- * Example usage:
- * @code
- * TelegramMonitor monitor;
- * monitor.startTelegramNotificationWatchThread();
- * // The bot will now monitor CPU and memory usage and send notifications as needed.
- * @endcode
+ * **Note**: The bot must have sufficient permissions to send messages to the specified chat.
  */
-void TelegramMonitor::thread_telegramNotification()
+void TelegramMonitor::checkUsageLimits(uint32_t sources, int64_t sampleNS)
 {
-    TgBot::Bot bot(settings.getBotToken());
+    // Evaluate the alert rules that depend on the new samples
+    int64_t nowMS = MetricStore::nowMS();
+    alertVariables.update(sources);
+    alerts.evaluate(nowMS, sources, [this, nowMS, sampleNS](int rule, AlertEvent event)
+                    {
+                        std::string text = alerts.formatMessage(rule, nowMS, event == ALERT_RESOLVED);
+                        if (event == ALERT_REMINDED)
+                        {
+                            text += "\n\nActive for " + std::to_string((nowMS - alerts.getState(rule).sinceMS) / 60000) + " min";
+                        }
+                        logger.logToConsole("alert '" + alerts.getRuleName(rule) + "': " + text.substr(0, text.find('\n')));
+                        alertLatency.add(SampleEvents::nowNS() - sampleNS);
+                        outbound.sendMessage(settings.getChatId(), text, alerts.getSeverity(rule) == ALERT_CRITICAL ? OUTBOUND_CRITICAL : OUTBOUND_ALERT); });
+    evaluationLatency.add(SampleEvents::nowNS() - sampleNS);
+
+    // Check disk limits
+    if ((sources & sampleSourceBit(SAMPLE_DISK)) && (settings.getDiskUtilLimit() > 0 || settings.getDiskAwaitLimitMS() > 0))
+    {
+        std::unordered_set<std::string> seen;
+        for (const DiskStats &stats : disk.getStats())
+        {
+            std::string name = stats.name;
+            seen.insert(name);
+            if (settings.getDiskUtilLimit() > 0)
+            {
+                int limit = settings.getDiskUtilLimit();
+                AlertEvent event = updateDeviceAlert("disk.util:" + name, stats.utilPercent >= limit, stats.utilPercent < clearThreshold(limit), nowMS);
+                if (event != ALERT_NONE)
+                {
+                    logger.logToConsole("disk " + name + (event == ALERT_RESOLVED ? " recovered" : " overload") + " (util " + std::to_string((int)stats.utilPercent) + "%)");
+                    outbound.sendMessage(settings.getChatId(), std::string(event == ALERT_RESOLVED ? "Disk Resolved\n" : "Disk Warning!\n") + name + " util : " + std::to_string((int)stats.utilPercent) + "%\nqueue : " + std::to_string((int)stats.queueDepth), OUTBOUND_ALERT);
+                }
+            }
+            if (settings.getDiskAwaitLimitMS() > 0)
+            {
+                int limit = settings.getDiskAwaitLimitMS();
+                AlertEvent event = updateDeviceAlert("disk.await:" + name, stats.awaitMS >= limit, stats.awaitMS < clearThreshold(limit), nowMS);
+                if (event != ALERT_NONE)
+                {
+                    logger.logToConsole("disk " + name + (event == ALERT_RESOLVED ? " latency recovered" : " latency") + " (await " + std::to_string((int)stats.awaitMS) + " ms)");
+                    outbound.sendMessage(settings.getChatId(), std::string(event == ALERT_RESOLVED ? "Disk Latency Resolved\n" : "Disk Latency Warning!\n") + name + " await : " + std::to_string((int)stats.awaitMS) + " ms", OUTBOUND_ALERT);
+                }
+            }
+        }
+        resolveMissingDevices("disk.", seen, "Disk Resolved");
+    }
 
-    // Check usage with limit
-    while (this->tgNotificationStatus)
+    // Check per-interface network limits
+    if (!(sources & sampleSourceBit(SAMPLE_NET)))
+    {
+        return;
+    }
+    std::unordered_set<std::string> seen;
+    for (const NetStats &stats : net.getStats())
     {
-        // Check cpu limit
-        if (settings.getCpuLimit() != 0 && settings.getCpuLimit() > 0 && cpu.getLastCpuUsage() >= settings.getCpuLimit())
+        if (stats.limitIndex < 0)
         {
-            logger.logToConsole("cpu overload (" + std::to_string((int)cpu.getLastCpuUsage()) + "%)");
-            bot.getApi().sendMessage(settings.getChatId(), "CPU Warning!\nCpu : " + std::to_string((int)cpu.getLastCpuUsage()) + "%");
+            continue;
         }
+        seen.insert(stats.name);
+
+        const NetLimitStructure &limit = net.getLimit(stats.limitIndex);
+        std::string name = stats.name;
+        int rxMbps = static_cast<int>(stats.rxBytesPerSec * 8 / 1000000.0);
+        int txMbps = static_cast<int>(stats.txBytesPerSec * 8 / 1000000.0);
+        int errors = static_cast<int>(stats.rxErrorsPerSec + stats.txErrorsPerSec);
+        int drops = static_cast<int>(stats.rxDropsPerSec + stats.txDropsPerSec);
 
-        // Check memory limit
-        if (settings.getMemoryLimit() != 0 && settings.getMemoryLimit() > 0 && memory.getLastMemoryUsage() >= settings.getMemoryLimit())
+        bool overload = (limit.rxMbps > 0 && rxMbps >= limit.rxMbps) || (limit.txMbps > 0 && txMbps >= limit.txMbps);
+        bool overloadCleared = (limit.rxMbps <= 0 || rxMbps < clearThreshold(limit.rxMbps)) && (limit.txMbps <= 0 || txMbps < clearThreshold(limit.txMbps));
+        AlertEvent event = updateDeviceAlert("net.throughput:" + name, overload, overloadCleared, nowMS);
+        if (event != ALERT_NONE)
         {
-            logger.logToConsole("memory overload (" + std::to_string((int)memory.getLastMemoryUsage()) + "%)");
-            bot.getApi().sendMessage(settings.getChatId(), "Memory Warning!\nMemory : " + std::to_string((int)memory.getLastMemoryUsage()) + "%");
+            logger.logToConsole("network " + name + (event == ALERT_RESOLVED ? " recovered" : " overload") + " (rx " + std::to_string(rxMbps) + " Mbit/s, tx " + std::to_string(txMbps) + " Mbit/s)");
+            outbound.sendMessage(settings.getChatId(), std::string(event == ALERT_RESOLVED ? "Network Resolved\n" : "Network Warning!\n") + name + " rx : " + std::to_string(rxMbps) + " Mbit/s\n" + name + " tx : " + std::to_string(txMbps) + " Mbit/s", OUTBOUND_ALERT);
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        bool failing = (limit.errorsPerSec > 0 && errors >= limit.errorsPerSec) || (limit.dropsPerSec > 0 && drops >= limit.dropsPerSec);
+        bool failingCleared = (limit.errorsPerSec <= 0 || errors < clearThreshold(limit.errorsPerSec)) && (limit.dropsPerSec <= 0 || drops < clearThreshold(limit.dropsPerSec));
+        event = updateDeviceAlert("net.errors:" + name, failing, failingCleared, nowMS);
+        if (event != ALERT_NONE)
+        {
+            logger.logToConsole("network " + name + (event == ALERT_RESOLVED ? " errors recovered" : " errors") + " (" + std::to_string(errors) + " errors/s, " + std::to_string(drops) + " drops/s)");
+            outbound.sendMessage(settings.getChatId(), std::string(event == ALERT_RESOLVED ? "Network Error Resolved\n" : "Network Error Warning!\n") + name + " errors : " + std::to_string(errors) + "/s\n" + name + " drops : " + std::to_string(drops) + "/s", OUTBOUND_ALERT);
+        }
     }
+    resolveMissingDevices("net.", seen, "Network Resolved");
+}
+
+/**
+ * @brief Advances the alert state of one device limit.
+ *
+ * Device limits are not rules (devices come and go), but they follow the same states: a
+ * warning when the limit is reached, a reminder every `alert_renotify_sec`, and a resolved
+ * message once the value is back below the clear threshold. Only devices with an active
+ * alert keep a state.
+ *
+ * @param key Limit and device, e.g. "disk.util:sda".
+ * @param triggered Whether the value reached the limit.
+ * @param cleared Whether the value is below the clear threshold.
+ * @return The notification due.
+ */
+AlertEvent TelegramMonitor::updateDeviceAlert(const std::string &key, bool triggered, bool cleared, int64_t nowMS)
+{
+    auto found = deviceAlerts.find(key);
+    if (found == deviceAlerts.end())
+    {
+        if (!triggered)
+        {
+            return ALERT_NONE;
+        }
+        found = deviceAlerts.emplace(key, AlertState()).first;
+    }
+
+    AlertEvent event = found->second.update(triggered, cleared, nowMS, 0, static_cast<int64_t>(settings.getAlertRenotifySec()) * 1000);
+    if (found->second.phase == ALERT_INACTIVE)
+    {
+        deviceAlerts.erase(found);
+    }
+    return event;
+}
+
+/**
+ * @brief Drops the alert states of devices that are gone.
+ *
+ * A disk or interface (e.g. a container's veth) can disappear while its alert is firing.
+ * It is no longer in the stats, so `updateDeviceAlert` never sees it clear; its firing
+ * alerts are resolved here with a "removed" message, pending ones are dropped silently.
+ *
+ * @param kind Key prefix of the limits checked by the pass, "disk." or "net.".
+ * @param seen Devices of the pass.
+ * @param title First line of the resolved message.
+ */
+void TelegramMonitor::resolveMissingDevices(const std::string &kind, const std::unordered_set<std::string> &seen, const std::string &title)
+{
+    for (auto device = deviceAlerts.begin(); device != deviceAlerts.end();)
+    {
+        const std::string &key = device->first;
+        std::string name = key.substr(key.find(':') + 1);
+        if (key.compare(0, kind.size(), kind) != 0 || seen.count(name))
+        {
+            ++device;
+            continue;
+        }
+
+        if (device->second.phase == ALERT_FIRING)
+        {
+            logger.logToConsole("device " + name + " removed, alert " + key + " resolved");
+            outbound.sendMessage(settings.getChatId(), title + "\n" + name + " : removed", OUTBOUND_ALERT);
+        }
+        device = deviceAlerts.erase(device);
+    }
+}
+
+// Value below which an alert on `limit` resolves
+double TelegramMonitor::clearThreshold(int limit) const
+{
+    return limit * (100.0 - settings.getAlertClearMargin()) / 100.0;
 }
@@ -5,36 +5,105 @@
 #include <thread>
 #include <chrono>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <atomic>
+#include <mutex>
 #include "settings/Settings.hpp"
 #include "log/Log.hpp"
 #include "cpu/CpuMonitor.hpp"
 #include "memory/MemoryMonitor.hpp"
+#include "scheduler/Scheduler.hpp"
+#include "pressure/PressureMonitor.hpp"
+#include "disk/DiskMonitor.hpp"
+#include "network/NetMonitor.hpp"
+#include "process/ProcessMonitor.hpp"
+#include "history/MetricStore.hpp"
+#include "chart/ChartRenderer.hpp"
+#include "history/HistoryExporter.hpp"
+#include "alert/AlertEngine.hpp"
+#include "alert/AlertVariables.hpp"
+#include "alert/LatencyHistogram.hpp"
+#include "telegram/OutboundQueue.hpp"
+#include "telegram/PooledHttpClient.hpp"
+#include "scheduler/SampleEvents.hpp"
 
 class TelegramMonitor
 {
 public:
-    TelegramMonitor(bool &isMonitoringEnable, CpuMonitor &cpu, MemoryMonitor &memory, const Settings settings, Log logger);
+    TelegramMonitor(Scheduler &scheduler, CpuMonitor &cpu, MemoryMonitor &memory, PressureMonitor &pressure, DiskMonitor &disk, NetMonitor &net, ProcessMonitor &processes, MetricStore &metrics, const Settings settings, Log logger);
 
     void startTelegramRequestThread();
-    void startTelegramNotificationWatchThread();
-    void stopTelegramNotificationWatchThread();
+
+    // Checks the limits depending on new samples of `sources` and sends warnings, called by the scheduler
+    void checkUsageLimits(uint32_t sources, int64_t sampleNS);
+
+    // Sends an alert raised by a collector (e.g. a PSI trigger)
+    void sendAlert(const std::string &text);
+
+    // Edits the live dashboard if its content changed, called periodically by the scheduler
+    void refreshDashboard();
 
 private:
     void thread_telegramBot();
-    void thread_telegramNotification();
     void handleStartCommand(TgBot::Message::Ptr message);
     void handleStopCommand(TgBot::Message::Ptr message);
     void handleUsageCommand(TgBot::Message::Ptr message);
     void handleHelpCommand(TgBot::Message::Ptr message);
     void handleStatusCommand(TgBot::Message::Ptr message);
+    void handleNetCommand(TgBot::Message::Ptr message);
+    void handleTopCommand(TgBot::Message::Ptr message);
+    void handleHistoryCommand(TgBot::Message::Ptr message);
+    void handleChartCommand(TgBot::Message::Ptr message);
+    void handleExportCommand(TgBot::Message::Ptr message);
+    void handleDashboardCommand(TgBot::Message::Ptr message);
+    void editDashboard(const TgBot::Api &api, int64_t chatId);
+    std::string formatCpuBreakdown();
+    std::string formatTopCores();
+    std::string formatMemoryDetails();
+    std::string formatPressure();
+    std::string formatDisks();
+    std::string formatTopProcesses(bool byCpu);
+    std::string formatPercentiles();
+    std::string formatSparklines();
+    std::string formatOutboundStats();
+    std::string formatDashboard();
+    static std::string formatLatency(const std::string &label, const LatencyHistogram &histogram);
+    std::vector<double> metricThresholds(const std::string &name);
+    void addLimitRules();
+    AlertEvent updateDeviceAlert(const std::string &key, bool triggered, bool cleared, int64_t nowMS);
+    void resolveMissingDevices(const std::string &kind, const std::unordered_set<std::string> &seen, const std::string &title);
+    double clearThreshold(int limit) const;
 
     Log logger;
     Settings settings;
     CpuMonitor &cpu;
     MemoryMonitor &memory;
-    bool &isMonitoringEnable;
-    bool tgNotificationStatus;
+    PressureMonitor &pressure;
+    DiskMonitor &disk;
+    NetMonitor &net;
+    ProcessMonitor &processes;
+    MetricStore &metrics;
+    ChartRenderer chartRenderer;
+    AlertEngine alerts;
+    AlertVariables alertVariables;
+    Scheduler &scheduler;
+    int cpuModeLimits[CPU_MODE_COUNT];
+    int pressureLimits[PRESSURE_RESOURCE_COUNT];
+    LatencyHistogram evaluationLatency; // sample to evaluated rules
+    LatencyHistogram alertLatency;      // sample to queued rule alert
+    std::unordered_map<std::string, AlertState> deviceAlerts; // active disk and network alerts by "limit:device"
     std::thread botRequestThread;
-    std::thread notificationThread;
+    PooledHttpClient httpClient; // before bot: the bot keeps a reference to it
     TgBot::Bot bot;
+    std::atomic<int32_t> dashboardMessageId; // pinned dashboard message, 0 if none
+    std::atomic<uint32_t> dashboardGeneration; // counts /dashboard commands, a queued post checks it is still current
+    std::atomic<int32_t> dashboardShownId;   // message and hash of the last delivered edit, set by the sender thread
+    std::atomic<uint64_t> dashboardHash;
+    std::mutex dashboardMutex;        // guards the pending edit below
+    bool dashboardEditQueued;         // an edit is queued or waiting for `retry_after`
+    int32_t dashboardPendingId;       // message, text and hash the queued edit sends
+    std::string dashboardPendingText;
+    uint64_t dashboardPendingHash;
+    OutboundQueue outbound; // after bot: sends through its api and stops before it
 };
@@ -0,0 +1,28 @@
+#include "TokenBucket.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+TokenBucket::TokenBucket(double ratePerSec, double burst)
+    : ratePerSec(std::max(ratePerSec, 0.001)), burst(std::max(burst, 1.0)), tokens(std::max(burst, 1.0)), lastNS(-1)
+{
+}
+
+void TokenBucket::refill(int64_t nowNS)
+{
+    if (lastNS >= 0 && nowNS > lastNS)
+    {
+        tokens = std::min(burst, tokens + (nowNS - lastNS) * ratePerSec / 1e9);
+    }
+    lastNS = std::max(lastNS, nowNS);
+}
+
+int64_t TokenBucket::waitNS(int64_t nowNS)
+{
+    refill(nowNS);
+    if (tokens >= 1.0)
+    {
+        return 0;
+    }
+    return static_cast<int64_t>(std::ceil((1.0 - tokens) * 1e9 / ratePerSec));
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Token bucket rate limiter on a caller-supplied monotonic clock.
+ *
+ * Holds up to `burst` tokens and refills `ratePerSec` tokens per second; every send takes
+ * one token. Not thread safe, owned by the sender thread.
+ */
+class TokenBucket
+{
+public:
+    TokenBucket(double ratePerSec, double burst);
+
+    // Nanoseconds until a token is available, 0 if one is available now
+    int64_t waitNS(int64_t nowNS);
+
+    // Takes a token, call only when waitNS() returned 0
+    void take() { tokens -= 1.0; }
+
+private:
+    void refill(int64_t nowNS);
+
+    double ratePerSec;
+    double burst;
+    double tokens;
+    int64_t lastNS;
+};